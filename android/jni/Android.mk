@@ -70,6 +70,6 @@ include $(GSTREAMER_NDK_BUILD_PATH)/plugins.mk
                              $(GSTREAMER_PLUGINS_NET_RESTRICTED)
 
 G_IO_MODULES              := gnutls
-GSTREAMER_EXTRA_DEPS      := gstreamer-video-1.0 json-glib-1.0
+GSTREAMER_EXTRA_DEPS      := gstreamer-video-1.0 gstreamer-app-1.0 json-glib-1.0
 
 include $(GSTREAMER_NDK_BUILD_PATH)/gstreamer-1.0.mk
\ No newline at end of file
@@ -31,6 +31,8 @@ static jmethodID on_rct_gst_pipeline_state_changed_method_id;
 static jmethodID on_rct_gst_pipeline_eos_method_id;
 static jmethodID on_rct_gst_pipeline_error_method_id;
 static jmethodID on_rct_gst_element_message_method_id;
+static jmethodID on_rct_gst_element_binary_message_method_id;
+static jmethodID on_rct_gst_pipeline_position_method_id;
 
 static void cb_on_rct_gst_player_loaded(RctGstPlayer *rct_gst_player);
 static void cb_on_rct_gst_pipeline_state_changed(RctGstPlayer *rct_gst_player, GstState new_state, GstState old_state);
@@ -42,6 +44,11 @@ static void cb_on_rct_gst_pipeline_error(RctGstPlayer *rct_gst_player,
 static void cb_on_rct_gst_element_message(RctGstPlayer *rct_gst_player,
                                           const gchar *element,
                                           const gchar *message);
+static void cb_on_rct_gst_element_binary_message(RctGstPlayer *rct_gst_player,
+                                                 const gchar *element,
+                                                 const guint8 *message_data,
+                                                 gsize message_size);
+static void cb_on_rct_gst_pipeline_position(RctGstPlayer *rct_gst_player, gint64 position, gint64 duration);
 
 // Returns a jstring containing an utf8 version of currently linked GStreamer
 static jstring get_gstreamer_version(JNIEnv *env, jobject thiz) {
@@ -81,11 +88,27 @@ static jobject create_rct_gst_player(JNIEnv *env, jobject thiz,
 
     (*env)->ReleaseStringUTFChars(env, j_debug_tag, debug_tag);
 
+    // Element messages are handed over to Java as direct ByteBuffers, without JSON
+    g_object_set(rct_gst_player,
+                 "element_message_format", RCT_GST_MESSAGE_FORMAT_BINARY,
+                 "on_rct_gst_element_message_binary", cb_on_rct_gst_element_binary_message,
+                 "on_rct_gst_pipeline_position", cb_on_rct_gst_pipeline_position,
+                 NULL);
+
     rct_gst_player_start(rct_gst_player);
 
     return (*env)->NewDirectByteBuffer(env, (void *) rct_gst_player, sizeof(RctGstPlayer *));
 }
 
+// Native windows are released only once the player doesn't use them anymore
+static void cb_release_native_window(RctGstPlayer *rct_gst_player, gboolean applied, gpointer native_window) {
+    (void) rct_gst_player;
+    (void) applied;
+
+    if (native_window)
+        ANativeWindow_release(native_window);
+}
+
 // Ask to kill the RctGstPlayer instance
 static void destroy_rct_gst_player(JNIEnv *env, jobject thiz,
                                    jobject j_rct_gst_player) {
@@ -96,10 +119,8 @@ static void destroy_rct_gst_player(JNIEnv *env, jobject thiz,
 
     rct_gst_player = (RctGstPlayer *) (*env)->GetDirectBufferAddress(env, j_rct_gst_player);
     g_object_get(rct_gst_player, "drawable_surface", &current_native_window, NULL);
-    g_object_set(rct_gst_player, "desired_state", GST_STATE_NULL, NULL);
-
-    if (current_native_window)
-        ANativeWindow_release(current_native_window);
+    rct_gst_player_post_desired_state(rct_gst_player, GST_STATE_NULL,
+                                      cb_release_native_window, current_native_window);
 
     __android_log_print(ANDROID_LOG_INFO, "JNI - RCTGstPlayer", "Destroying player");
     rct_gst_player_stop(rct_gst_player);
@@ -141,15 +162,13 @@ static void set_drawable_surface(JNIEnv *env, jobject thiz,
     g_object_get(rct_gst_player, "drawable_surface", &current_native_window, NULL);
 
     if (current_native_window) {
-        ANativeWindow_release(current_native_window);
-
         if (current_native_window == new_native_window) {
             __android_log_print(ANDROID_LOG_INFO, "JNI - RCTGstPlayer",
                                 "New native window is the same as the previous one %p",
                                 current_native_window);
         } else {
             __android_log_print(ANDROID_LOG_INFO, "JNI - RCTGstPlayer",
-                                "Released previous native window %p",
+                                "Releasing previous native window %p",
                                 current_native_window);
         }
     }
@@ -158,7 +177,8 @@ static void set_drawable_surface(JNIEnv *env, jobject thiz,
                         "Setting native window : %p",
                         new_native_window);
 
-    g_object_set(rct_gst_player, "drawable_surface", new_native_window, NULL);
+    rct_gst_player_post_drawable_surface(rct_gst_player, new_native_window,
+                                         cb_release_native_window, current_native_window);
 }
 
 static void set_pipeline_state(JNIEnv *env, jobject thiz,
@@ -194,6 +214,108 @@ static void set_pipeline_properties(JNIEnv *env, jobject thiz,
     (*env)->ReleaseStringUTFChars(env, j_pipeline_properties, pipeline_properties);
 }
 
+static void set_position_update_interval(JNIEnv *env, jobject thiz,
+                                         jobject j_rct_gst_player,
+                                         jint j_position_update_interval) {
+    (void) thiz;
+    RctGstPlayer *rct_gst_player = NULL;
+
+    rct_gst_player = (RctGstPlayer *) (*env)->GetDirectBufferAddress(env, j_rct_gst_player);
+    g_object_set(rct_gst_player, "position_update_interval", (guint) MAX(j_position_update_interval, 0), NULL);
+}
+
+// Typed property setters, no JSON involved : each value is posted as a one entry batch
+static void set_element_property_long(JNIEnv *env, jobject thiz,
+                                      jobject j_rct_gst_player,
+                                      jstring j_element_name,
+                                      jstring j_property_name,
+                                      jlong j_value) {
+    (void) thiz;
+
+    RctGstPlayer *rct_gst_player = NULL;
+    RctGstPropertyBatch *batch = NULL;
+    const gchar *element_name = (*env)->GetStringUTFChars(env, j_element_name, NULL);
+    const gchar *property_name = (*env)->GetStringUTFChars(env, j_property_name, NULL);
+
+    rct_gst_player = (RctGstPlayer *) (*env)->GetDirectBufferAddress(env, j_rct_gst_player);
+
+    batch = rct_gst_property_batch_new();
+    rct_gst_property_batch_add_int(batch, element_name, property_name, (gint64) j_value);
+    rct_gst_player_post_property_batch(rct_gst_player, batch, NULL, NULL);
+
+    (*env)->ReleaseStringUTFChars(env, j_element_name, element_name);
+    (*env)->ReleaseStringUTFChars(env, j_property_name, property_name);
+}
+
+static void set_element_property_double(JNIEnv *env, jobject thiz,
+                                        jobject j_rct_gst_player,
+                                        jstring j_element_name,
+                                        jstring j_property_name,
+                                        jdouble j_value) {
+    (void) thiz;
+
+    RctGstPlayer *rct_gst_player = NULL;
+    RctGstPropertyBatch *batch = NULL;
+    const gchar *element_name = (*env)->GetStringUTFChars(env, j_element_name, NULL);
+    const gchar *property_name = (*env)->GetStringUTFChars(env, j_property_name, NULL);
+
+    rct_gst_player = (RctGstPlayer *) (*env)->GetDirectBufferAddress(env, j_rct_gst_player);
+
+    batch = rct_gst_property_batch_new();
+    rct_gst_property_batch_add_double(batch, element_name, property_name, (gdouble) j_value);
+    rct_gst_player_post_property_batch(rct_gst_player, batch, NULL, NULL);
+
+    (*env)->ReleaseStringUTFChars(env, j_element_name, element_name);
+    (*env)->ReleaseStringUTFChars(env, j_property_name, property_name);
+}
+
+static void set_element_property_boolean(JNIEnv *env, jobject thiz,
+                                         jobject j_rct_gst_player,
+                                         jstring j_element_name,
+                                         jstring j_property_name,
+                                         jboolean j_value) {
+    (void) thiz;
+
+    RctGstPlayer *rct_gst_player = NULL;
+    RctGstPropertyBatch *batch = NULL;
+    const gchar *element_name = (*env)->GetStringUTFChars(env, j_element_name, NULL);
+    const gchar *property_name = (*env)->GetStringUTFChars(env, j_property_name, NULL);
+
+    rct_gst_player = (RctGstPlayer *) (*env)->GetDirectBufferAddress(env, j_rct_gst_player);
+
+    batch = rct_gst_property_batch_new();
+    rct_gst_property_batch_add_boolean(batch, element_name, property_name, j_value ? TRUE : FALSE);
+    rct_gst_player_post_property_batch(rct_gst_player, batch, NULL, NULL);
+
+    (*env)->ReleaseStringUTFChars(env, j_element_name, element_name);
+    (*env)->ReleaseStringUTFChars(env, j_property_name, property_name);
+}
+
+static void set_element_property_string(JNIEnv *env, jobject thiz,
+                                        jobject j_rct_gst_player,
+                                        jstring j_element_name,
+                                        jstring j_property_name,
+                                        jstring j_value) {
+    (void) thiz;
+
+    RctGstPlayer *rct_gst_player = NULL;
+    RctGstPropertyBatch *batch = NULL;
+    const gchar *element_name = (*env)->GetStringUTFChars(env, j_element_name, NULL);
+    const gchar *property_name = (*env)->GetStringUTFChars(env, j_property_name, NULL);
+    const gchar *value = (*env)->GetStringUTFChars(env, j_value, NULL);
+
+    rct_gst_player = (RctGstPlayer *) (*env)->GetDirectBufferAddress(env, j_rct_gst_player);
+
+    // The batch keeps its own copy of the string
+    batch = rct_gst_property_batch_new();
+    rct_gst_property_batch_add_string(batch, element_name, property_name, value);
+    rct_gst_player_post_property_batch(rct_gst_player, batch, NULL, NULL);
+
+    (*env)->ReleaseStringUTFChars(env, j_element_name, element_name);
+    (*env)->ReleaseStringUTFChars(env, j_property_name, property_name);
+    (*env)->ReleaseStringUTFChars(env, j_value, value);
+}
+
 // Java callbacks bindings
 static void cb_on_rct_gst_player_loaded(RctGstPlayer *rct_gst_player) {
     JNIEnv *env = NULL;
@@ -285,6 +407,40 @@ static void cb_on_rct_gst_element_message(RctGstPlayer *rct_gst_player,
     (*env)->DeleteLocalRef(env, j_message_details);
 }
 
+// The ByteBuffer wraps the player's own buffer : Java has to decode it before returning
+static void cb_on_rct_gst_element_binary_message(RctGstPlayer *rct_gst_player,
+                                                 const gchar *element_name,
+                                                 const guint8 *message_data,
+                                                 gsize message_size) {
+    JNIEnv *env = NULL;
+    jstring j_element_name = NULL;
+    jobject j_message = NULL;
+
+    env = get_jni_env();
+    j_element_name = (*env)->NewStringUTF(env, element_name);
+    j_message = (*env)->NewDirectByteBuffer(env, (void *) message_data, (jlong) message_size);
+
+    AndroidUserData *user_data = (AndroidUserData *) rct_gst_player_get_user_data(rct_gst_player);
+    (*env)->CallVoidMethod(env, user_data->thiz, on_rct_gst_element_binary_message_method_id,
+                           j_element_name,
+                           j_message);
+
+    (*env)->DeleteLocalRef(env, j_element_name);
+    (*env)->DeleteLocalRef(env, j_message);
+}
+
+// Nanoseconds, -1 when unknown
+static void cb_on_rct_gst_pipeline_position(RctGstPlayer *rct_gst_player, gint64 position, gint64 duration) {
+    JNIEnv *env = NULL;
+
+    env = get_jni_env();
+
+    AndroidUserData *user_data = (AndroidUserData *) rct_gst_player_get_user_data(rct_gst_player);
+    (*env)->CallVoidMethod(env, user_data->thiz, on_rct_gst_pipeline_position_method_id,
+                           (jlong) position,
+                           (jlong) duration);
+}
+
 /*
  * JNI Native methods bindings
  */
@@ -295,6 +451,11 @@ static JNINativeMethod gst_player_controller_native_methods[] = {
         {"jniSetDrawableSurface",     "(Ljava/nio/ByteBuffer;Landroid/view/Surface;)V", (void *) set_drawable_surface},
         {"jniSetPipelineState",       "(Ljava/nio/ByteBuffer;I)V",                      (void *) set_pipeline_state},
         {"jniSetPipelineProperties",  "(Ljava/nio/ByteBuffer;Ljava/lang/String;)V",     (void *) set_pipeline_properties},
+        {"jniSetPositionUpdateInterval", "(Ljava/nio/ByteBuffer;I)V",                   (void *) set_position_update_interval},
+        {"jniSetElementPropertyLong",    "(Ljava/nio/ByteBuffer;Ljava/lang/String;Ljava/lang/String;J)V",                  (void *) set_element_property_long},
+        {"jniSetElementPropertyDouble",  "(Ljava/nio/ByteBuffer;Ljava/lang/String;Ljava/lang/String;D)V",                  (void *) set_element_property_double},
+        {"jniSetElementPropertyBoolean", "(Ljava/nio/ByteBuffer;Ljava/lang/String;Ljava/lang/String;Z)V",                  (void *) set_element_property_boolean},
+        {"jniSetElementPropertyString",  "(Ljava/nio/ByteBuffer;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)V", (void *) set_element_property_string},
 };
 
 static JNINativeMethod gst_player_manager_native_methods[] = {
@@ -398,6 +559,16 @@ jint JNI_OnLoad(JavaVM *vm, void *reserved) {
                                                            "onGstElementMessage",
                                                            "(Ljava/lang/String;Ljava/lang/String;)V");
 
+    on_rct_gst_element_binary_message_method_id = (*env)->GetMethodID(env,
+                                                                  gst_player_controller_class,
+                                                                  "onGstElementBinaryMessage",
+                                                                  "(Ljava/lang/String;Ljava/nio/ByteBuffer;)V");
+
+    on_rct_gst_pipeline_position_method_id = (*env)->GetMethodID(env,
+                                                                 gst_player_controller_class,
+                                                                 "onGstPipelinePosition",
+                                                                 "(JJ)V");
+
     pthread_key_create(&current_jni_env, detach_current_thread);
 
     return JNI_VERSION_1_6;
@@ -3,6 +3,7 @@ package com.asap.reactnativegstplayer;
 import android.util.Log;
 import android.widget.Toast;
 
+import com.facebook.react.bridge.ReadableArray;
 import com.facebook.react.bridge.ReadableMap;
 import com.facebook.react.bridge.ReadableNativeMap;
 import com.facebook.react.common.MapBuilder;
@@ -22,6 +23,9 @@ public class GstPlayerManager extends SimpleViewManager<GstPlayerView> {
     private static final String REACT_CLASS = "RCTGstPlayer";
     private static boolean GSTREAMER_INITIALIZED = false;
 
+    // Commands
+    private static final int COMMAND_SET_ELEMENT_PROPERTY = 1;
+
     private native String jniGetGStreamerVersion();
 
     @Override
@@ -67,6 +71,50 @@ public class GstPlayerManager extends SimpleViewManager<GstPlayerView> {
         view.getController().setPipelineProperties(pipelineProperties);
     }
 
+    @ReactProp(name = "positionUpdateInterval")
+    public void setPositionUpdateInterval(GstPlayerView view, int positionUpdateInterval) {
+        view.getController().setPositionUpdateInterval(positionUpdateInterval);
+    }
+
+    @Nullable
+    @Override
+    public Map<String, Integer> getCommandsMap() {
+        return MapBuilder.of("setElementProperty", COMMAND_SET_ELEMENT_PROPERTY);
+    }
+
+    @Override
+    public void receiveCommand(GstPlayerView view, int commandId, @Nullable ReadableArray args) {
+        if (commandId != COMMAND_SET_ELEMENT_PROPERTY || args == null || args.size() < 3)
+            return;
+
+        Object value = null;
+
+        switch (args.getType(2)) {
+            case Boolean:
+                value = args.getBoolean(2);
+                break;
+
+            // JS numbers are doubles : whole ones go through the integer setter
+            case Number:
+                double number = args.getDouble(2);
+                if (number == Math.rint(number) && Math.abs(number) <= Long.MAX_VALUE)
+                    value = (long) number;
+                else
+                    value = number;
+                break;
+
+            case String:
+                value = args.getString(2);
+                break;
+
+            default:
+                break;
+        }
+
+        if (value == null || !view.getController().setElementProperty(args.getString(0), args.getString(1), value))
+            Log.w(REACT_CLASS, "Unable to set " + args.getString(0) + "." + args.getString(1));
+    }
+
     @Nullable
     @Override
     public Map<String, Object> getExportedCustomDirectEventTypeConstants() {
@@ -79,6 +127,8 @@ public class GstPlayerManager extends SimpleViewManager<GstPlayerView> {
                         "onGstPipelineError", MapBuilder.of("registrationName", "onGstPipelineError")
                 ).put(
                         "onGstElementMessage", MapBuilder.of("registrationName", "onGstElementMessage")
+                ).put(
+                        "onGstPipelinePosition", MapBuilder.of("registrationName", "onGstPipelinePosition")
                 ).build();
     }
 
@@ -6,6 +6,7 @@ import android.view.SurfaceHolder;
 import android.view.View;
 
 import com.asap.reactnativegstplayer.utils.GstState;
+import com.asap.reactnativegstplayer.utils.GstStructureDecoder;
 import com.facebook.react.bridge.Arguments;
 import com.facebook.react.bridge.LifecycleEventListener;
 import com.facebook.react.bridge.ReactContext;
@@ -26,6 +27,11 @@ public class GstPlayerViewController implements LifecycleEventListener, SurfaceH
     private native void jniSetDrawableSurface(ByteBuffer nativeGstPlayer, Surface surface);
     private native void jniSetPipelineState(ByteBuffer nativeGstPlayer, int gstState);
     private native void jniSetPipelineProperties(ByteBuffer nativeGstPlayer, String pipelineProperties);
+    private native void jniSetPositionUpdateInterval(ByteBuffer nativeGstPlayer, int positionUpdateInterval);
+    private native void jniSetElementPropertyLong(ByteBuffer nativeGstPlayer, String elementName, String propertyName, long value);
+    private native void jniSetElementPropertyDouble(ByteBuffer nativeGstPlayer, String elementName, String propertyName, double value);
+    private native void jniSetElementPropertyBoolean(ByteBuffer nativeGstPlayer, String elementName, String propertyName, boolean value);
+    private native void jniSetElementPropertyString(ByteBuffer nativeGstPlayer, String elementName, String propertyName, String value);
 
     // View
     private GstPlayerView view = null;
@@ -41,6 +47,7 @@ public class GstPlayerViewController implements LifecycleEventListener, SurfaceH
     private String parseLaunchPipeline = null;
     private int pipelineState = -1;
     private String pipelineProperties = null;
+    private int positionUpdateInterval = 0;
 
     // Debug Tags
     private String getTag() {
@@ -63,6 +70,9 @@ public class GstPlayerViewController implements LifecycleEventListener, SurfaceH
 
         if (this.pipelineState > -1)
             this.jniSetPipelineState(this.nativeGstPlayer, this.pipelineState);
+
+        if (this.positionUpdateInterval > 0)
+            this.jniSetPositionUpdateInterval(this.nativeGstPlayer, this.positionUpdateInterval);
     }
 
     @SuppressWarnings("unused") // Used only from JNI
@@ -122,6 +132,30 @@ public class GstPlayerViewController implements LifecycleEventListener, SurfaceH
         );
     }
 
+    @SuppressWarnings("unused") // Used only from JNI
+    public void onGstElementBinaryMessage(String element, ByteBuffer message) {
+        // The buffer is reused by the native player once this method returns
+        WritableMap event = Arguments.createMap();
+        event.putString("element", element);
+        event.putMap("message", GstStructureDecoder.decode(message));
+
+        context.getJSModule(RCTEventEmitter.class).receiveEvent(
+                view.getId(), "onGstElementMessage", event
+        );
+    }
+
+    @SuppressWarnings("unused") // Used only from JNI
+    public void onGstPipelinePosition(long position, long duration) {
+        // Milliseconds, -1 when unknown
+        WritableMap event = Arguments.createMap();
+        event.putDouble("position", position < 0 ? -1 : position / 1e6);
+        event.putDouble("duration", duration < 0 ? -1 : duration / 1e6);
+
+        context.getJSModule(RCTEventEmitter.class).receiveEvent(
+                view.getId(), "onGstPipelinePosition", event
+        );
+    }
+
     // Getters
     int getPlayerIndex() {
         return this.playerIndex;
@@ -167,6 +201,33 @@ public class GstPlayerViewController implements LifecycleEventListener, SurfaceH
             this.jniSetPipelineProperties(this.nativeGstPlayer, this.pipelineProperties);
     }
 
+    void setPositionUpdateInterval(int positionUpdateInterval) {
+        Log.i(this.getTag(), "Set position update interval : " + positionUpdateInterval);
+
+        this.positionUpdateInterval = positionUpdateInterval;
+        if (this.playerReady)
+            this.jniSetPositionUpdateInterval(this.nativeGstPlayer, this.positionUpdateInterval);
+    }
+
+    // Typed element properties : posted to the player thread, without going through JSON
+    boolean setElementProperty(String elementName, String propertyName, Object value) {
+        if (!this.playerReady || this.currentGstState < GstState.READY)
+            return false;
+
+        if (value instanceof Boolean)
+            this.jniSetElementPropertyBoolean(this.nativeGstPlayer, elementName, propertyName, (Boolean) value);
+        else if (value instanceof Double || value instanceof Float)
+            this.jniSetElementPropertyDouble(this.nativeGstPlayer, elementName, propertyName, ((Number) value).doubleValue());
+        else if (value instanceof Number)
+            this.jniSetElementPropertyLong(this.nativeGstPlayer, elementName, propertyName, ((Number) value).longValue());
+        else if (value instanceof String)
+            this.jniSetElementPropertyString(this.nativeGstPlayer, elementName, propertyName, (String) value);
+        else
+            return false;
+
+        return true;
+    }
+
     @Override
     public void onHostResume() {
         if (this.playerReady && this.currentGstState == 3 && this.pipelineState != this.currentGstState)
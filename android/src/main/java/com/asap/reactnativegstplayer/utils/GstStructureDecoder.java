@@ -0,0 +1,121 @@
+package com.asap.reactnativegstplayer.utils;
+
+import com.facebook.react.bridge.Arguments;
+import com.facebook.react.bridge.WritableArray;
+import com.facebook.react.bridge.WritableMap;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.Charset;
+
+// Decodes element messages encoded by the native player (see RctGstBinaryType in gst_player.h)
+public class GstStructureDecoder {
+    private static final int NULL = 0;
+    private static final int INT32 = 1;
+    private static final int UINT32 = 2;
+    private static final int INT64 = 3;
+    private static final int UINT64 = 4;
+    private static final int FLOAT = 5;
+    private static final int DOUBLE = 6;
+    private static final int BOOLEAN = 7;
+    private static final int STRING = 8;
+    private static final int ARRAY = 9;
+
+    private static final Charset UTF8 = Charset.forName("UTF-8");
+
+    public static WritableMap decode(ByteBuffer buffer) {
+        WritableMap structure = Arguments.createMap();
+
+        buffer.order(ByteOrder.nativeOrder());
+        while (buffer.hasRemaining()) {
+            int type = buffer.get() & 0xFF;
+            String name = readString(buffer, buffer.getShort() & 0xFFFF);
+
+            putValue(structure, name, type, buffer);
+        }
+
+        return structure;
+    }
+
+    private static String readString(ByteBuffer buffer, int length) {
+        byte[] bytes = new byte[length];
+        buffer.get(bytes);
+
+        return new String(bytes, UTF8);
+    }
+
+    private static void putValue(WritableMap structure, String name, int type, ByteBuffer buffer) {
+        switch (type) {
+            case INT32:
+                structure.putInt(name, buffer.getInt());
+                break;
+            case UINT32:
+                structure.putDouble(name, buffer.getInt() & 0xFFFFFFFFL);
+                break;
+            case INT64:
+            case UINT64:
+                structure.putDouble(name, buffer.getLong());
+                break;
+            case FLOAT:
+                structure.putDouble(name, buffer.getFloat());
+                break;
+            case DOUBLE:
+                structure.putDouble(name, buffer.getDouble());
+                break;
+            case BOOLEAN:
+                structure.putBoolean(name, buffer.get() != 0);
+                break;
+            case STRING:
+                structure.putString(name, readString(buffer, buffer.getInt()));
+                break;
+            case ARRAY:
+                structure.putArray(name, readArray(buffer));
+                break;
+            default:
+                structure.putNull(name);
+                break;
+        }
+    }
+
+    private static WritableArray readArray(ByteBuffer buffer) {
+        WritableArray array = Arguments.createArray();
+        int count = buffer.getInt();
+
+        for (int i = 0; i < count; i++) {
+            int type = buffer.get() & 0xFF;
+
+            switch (type) {
+                case INT32:
+                    array.pushInt(buffer.getInt());
+                    break;
+                case UINT32:
+                    array.pushDouble(buffer.getInt() & 0xFFFFFFFFL);
+                    break;
+                case INT64:
+                case UINT64:
+                    array.pushDouble(buffer.getLong());
+                    break;
+                case FLOAT:
+                    array.pushDouble(buffer.getFloat());
+                    break;
+                case DOUBLE:
+                    array.pushDouble(buffer.getDouble());
+                    break;
+                case BOOLEAN:
+                    array.pushBoolean(buffer.get() != 0);
+                    break;
+                case STRING:
+                    array.pushString(readString(buffer, buffer.getInt()));
+                    break;
+                case ARRAY:
+                    array.pushArray(readArray(buffer));
+                    break;
+                default:
+                    array.pushNull();
+                    break;
+            }
+        }
+
+        return array;
+    }
+}
@@ -0,0 +1,906 @@
+#include <stdio.h>
+#include <string.h>
+#include <gio/gio.h>
+#include <json-glib/json-glib.h>
+#include "gst_player.h"
+
+/*
+ * Headless benchmarks of RctGstPlayer, results are written as JSON.
+ * Every pipeline ends in a fakesink, nothing is displayed nor played.
+ */
+
+#define BENCH_TIMEOUT (10 * G_USEC_PER_SEC)
+
+// Served over HTTP : 8 kHz mono 16 bits silence
+#define BENCH_WAV_RATE 8000
+#define BENCH_WAV_SECONDS 4
+
+static const gchar *video_pipeline = "videotestsrc name=videoSrc ! video/x-raw,width=320,height=240 ! fakesink name=videoSink sync=false";
+static const gchar *audio_pipeline = "audiotestsrc name=audioSrc ! volume name=volumeControl ! fakesink name=audioSink sync=false";
+static const gchar *level_pipeline = "audiotestsrc name=audioSrc ! level name=levelInfo interval=1000000 post-messages=true ! fakesink sync=false";
+static const gchar *live_pipeline = "videotestsrc is-live=true ! video/x-raw,width=320,height=240,framerate=30/1 ! fakesink";
+static const gchar *clip_pipeline = "videotestsrc num-buffers=30 ! video/x-raw,width=320,height=240,framerate=30/1 ! fakesink sync=true";
+static const gchar *udp_sender_pipeline = "videotestsrc is-live=true ! video/x-raw,format=I420,width=320,height=240,framerate=30/1 ! rtpvrawpay ! udpsink host=127.0.0.1 port=5004";
+static const gchar *hd_pipeline = "videotestsrc ! video/x-raw,width=1920,height=1080,framerate=30/1 ! queue ! videoconvert ! queue ! fakesink sync=true";
+static const gchar *udp_pipeline = "udpsrc port=5004 caps=\"application/x-rtp,media=video,clock-rate=90000,encoding-name=RAW,sampling=YCbCr-4:2:0,depth=(string)8,width=(string)320,height=(string)240\" ! rtpjitterbuffer ! rtpvrawdepay ! queue ! videoconvert ! fakesink";
+
+static gint n_iterations = 20;
+static gint n_players = 30;
+static gint n_property_writes = 10000;
+static gdouble message_duration = 2.0;
+static gint http_rate = 12000;
+static gchar *output_path = NULL;
+
+static GOptionEntry option_entries[] = {
+  {"iterations", 'i', 0, G_OPTION_ARG_INT, &n_iterations, "Iterations of each timed operation", "N"},
+  {"players", 'p', 0, G_OPTION_ARG_INT, &n_players, "Concurrent players of the load test", "N"},
+  {"property-writes", 'w', 0, G_OPTION_ARG_INT, &n_property_writes, "Property writes of the throughput test", "N"},
+  {"message-duration", 'm', 0, G_OPTION_ARG_DOUBLE, &message_duration, "Seconds of element messages counting", "S"},
+  {"http-rate", 'r', 0, G_OPTION_ARG_INT, &http_rate, "Bytes per second of the throttled HTTP server", "N"},
+  {"output", 'o', 0, G_OPTION_ARG_FILENAME, &output_path, "JSON results file (stdout by default)", "FILE"},
+  {NULL}
+};
+
+// State shared with the player callbacks, which run on the player threads
+typedef struct {
+  GMutex lock;
+  GCond cond;
+  gboolean loaded;
+  GstState state;
+  gboolean applied;
+  guint64 element_messages;
+  gboolean eos;
+  guint64 buffering_updates;
+  GArray *playlist_gaps;
+  guint64 memory_budget_reports;
+} BenchPlayer;
+
+static void cb_on_rct_gst_player_loaded(RctGstPlayer *rct_gst_player)
+{
+  BenchPlayer *bench_player = rct_gst_player_get_user_data(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  bench_player->loaded = TRUE;
+  g_cond_broadcast(&bench_player->cond);
+  g_mutex_unlock(&bench_player->lock);
+}
+
+static void cb_on_rct_gst_pipeline_state_changed(RctGstPlayer *rct_gst_player, GstState new_state, GstState old_state)
+{
+  BenchPlayer *bench_player = rct_gst_player_get_user_data(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  bench_player->state = new_state;
+  g_cond_broadcast(&bench_player->cond);
+  g_mutex_unlock(&bench_player->lock);
+}
+
+static void cb_on_rct_gst_pipeline_eos(RctGstPlayer *rct_gst_player)
+{
+  BenchPlayer *bench_player = rct_gst_player_get_user_data(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  bench_player->eos = TRUE;
+  g_cond_broadcast(&bench_player->cond);
+  g_mutex_unlock(&bench_player->lock);
+}
+
+static void cb_on_rct_gst_pipeline_error(RctGstPlayer *rct_gst_player, const gchar *source, const gchar *message, const gchar *debug_info)
+{
+  g_printerr("Pipeline Error from '%s' : %s\n", source, message);
+}
+
+static void cb_on_rct_gst_element_message(RctGstPlayer *rct_gst_player, const gchar *element_name, const gchar *message)
+{
+  BenchPlayer *bench_player = rct_gst_player_get_user_data(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  bench_player->element_messages++;
+  g_mutex_unlock(&bench_player->lock);
+}
+
+static void cb_on_rct_gst_element_message_binary(RctGstPlayer *rct_gst_player, const gchar *element_name, const guint8 *message_data, gsize message_size)
+{
+  cb_on_rct_gst_element_message(rct_gst_player, element_name, NULL);
+}
+
+static void cb_on_rct_gst_buffering(RctGstPlayer *rct_gst_player, gint percent, gint64 time_to_ready)
+{
+  BenchPlayer *bench_player = rct_gst_player_get_user_data(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  bench_player->buffering_updates++;
+  g_mutex_unlock(&bench_player->lock);
+}
+
+static void cb_on_rct_gst_playlist_item(RctGstPlayer *rct_gst_player, guint index, gint64 gap)
+{
+  BenchPlayer *bench_player = rct_gst_player_get_user_data(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  if (gap >= 0)
+    g_array_append_val(bench_player->playlist_gaps, gap);
+  g_mutex_unlock(&bench_player->lock);
+}
+
+static void cb_on_rct_gst_memory_budget(RctGstPlayer *rct_gst_player, guint64 buffered_bytes, guint64 memory_budget)
+{
+  BenchPlayer *bench_player = rct_gst_player_get_user_data(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  bench_player->memory_budget_reports++;
+  g_mutex_unlock(&bench_player->lock);
+}
+
+static void cb_command_applied(RctGstPlayer *rct_gst_player, gboolean applied, gpointer user_data)
+{
+  BenchPlayer *bench_player = user_data;
+
+  g_mutex_lock(&bench_player->lock);
+  bench_player->applied = TRUE;
+  g_cond_broadcast(&bench_player->cond);
+  g_mutex_unlock(&bench_player->lock);
+}
+
+// Player lifecycle
+// Callbacks may still run while a player stops : bench players are kept until the process exits
+static BenchPlayer *bench_player_alloc(void)
+{
+  BenchPlayer *bench_player = g_new0(BenchPlayer, 1);
+
+  g_mutex_init(&bench_player->lock);
+  g_cond_init(&bench_player->cond);
+  bench_player->state = GST_STATE_VOID_PENDING;
+  bench_player->playlist_gaps = g_array_new(FALSE, FALSE, sizeof(gint64));
+
+  return bench_player;
+}
+
+static RctGstPlayer *bench_player_new(BenchPlayer *bench_player, gboolean use_shared_executor)
+{
+  RctGstPlayer *rct_gst_player = NULL;
+
+  rct_gst_player = rct_gst_player_new("Bench Player",
+                                      cb_on_rct_gst_player_loaded,
+                                      cb_on_rct_gst_pipeline_state_changed,
+                                      cb_on_rct_gst_pipeline_eos,
+                                      cb_on_rct_gst_pipeline_error,
+                                      cb_on_rct_gst_element_message,
+                                      bench_player);
+
+  g_object_set(rct_gst_player,
+               "use_shared_executor", use_shared_executor,
+               "trace_level", RCT_GST_TRACE_LEVEL_NONE,
+               NULL);
+
+  rct_gst_player_start(rct_gst_player);
+  return rct_gst_player;
+}
+
+static void bench_player_stop(RctGstPlayer *rct_gst_player)
+{
+  g_object_set(rct_gst_player, "desired_state", GST_STATE_NULL, NULL);
+  rct_gst_player_stop(rct_gst_player);
+  g_object_unref(rct_gst_player);
+}
+
+static gboolean bench_player_wait_loaded(BenchPlayer *bench_player)
+{
+  gint64 end_time = g_get_monotonic_time() + BENCH_TIMEOUT;
+  gboolean loaded = FALSE;
+
+  g_mutex_lock(&bench_player->lock);
+  while (!bench_player->loaded && g_cond_wait_until(&bench_player->cond, &bench_player->lock, end_time))
+    ;
+  loaded = bench_player->loaded;
+  g_mutex_unlock(&bench_player->lock);
+
+  return loaded;
+}
+
+static gboolean bench_player_wait_state(BenchPlayer *bench_player, GstState state)
+{
+  gint64 end_time = g_get_monotonic_time() + BENCH_TIMEOUT;
+  gboolean reached = FALSE;
+
+  g_mutex_lock(&bench_player->lock);
+  while (bench_player->state != state && g_cond_wait_until(&bench_player->cond, &bench_player->lock, end_time))
+    ;
+  reached = bench_player->state == state;
+  g_mutex_unlock(&bench_player->lock);
+
+  return reached;
+}
+
+static gboolean bench_player_wait_applied(BenchPlayer *bench_player)
+{
+  gint64 end_time = g_get_monotonic_time() + BENCH_TIMEOUT;
+  gboolean applied = FALSE;
+
+  g_mutex_lock(&bench_player->lock);
+  while (!bench_player->applied && g_cond_wait_until(&bench_player->cond, &bench_player->lock, end_time))
+    ;
+  applied = bench_player->applied;
+  bench_player->applied = FALSE;
+  g_mutex_unlock(&bench_player->lock);
+
+  return applied;
+}
+
+static gboolean bench_player_wait_eos(BenchPlayer *bench_player, gint64 timeout)
+{
+  gint64 end_time = g_get_monotonic_time() + timeout;
+  gboolean eos = FALSE;
+
+  g_mutex_lock(&bench_player->lock);
+  while (!bench_player->eos && g_cond_wait_until(&bench_player->cond, &bench_player->lock, end_time))
+    ;
+  eos = bench_player->eos;
+  g_mutex_unlock(&bench_player->lock);
+
+  return eos;
+}
+
+static void bench_player_play(RctGstPlayer *rct_gst_player, BenchPlayer *bench_player, const gchar *pipeline)
+{
+  g_mutex_lock(&bench_player->lock);
+  bench_player->state = GST_STATE_VOID_PENDING;
+  g_mutex_unlock(&bench_player->lock);
+
+  g_object_set(rct_gst_player,
+               "desired_state", GST_STATE_PLAYING,
+               "parse_launch_pipeline", pipeline,
+               NULL);
+}
+
+// Throttled HTTP server
+// Each connection runs on its own thread, ranges are ignored : the whole file is always sent
+static GBytes *bench_wav_new(void)
+{
+  GByteArray *wav = g_byte_array_new();
+  guint32 data_size = BENCH_WAV_RATE * 2 * BENCH_WAV_SECONDS;
+  guint32 value32 = 0;
+  guint16 value16 = 0;
+
+  g_byte_array_append(wav, (const guint8 *) "RIFF", 4);
+  value32 = GUINT32_TO_LE(36 + data_size);
+  g_byte_array_append(wav, (const guint8 *) &value32, 4);
+  g_byte_array_append(wav, (const guint8 *) "WAVEfmt ", 8);
+  value32 = GUINT32_TO_LE(16);
+  g_byte_array_append(wav, (const guint8 *) &value32, 4);
+  value16 = GUINT16_TO_LE(1); // PCM
+  g_byte_array_append(wav, (const guint8 *) &value16, 2);
+  value16 = GUINT16_TO_LE(1); // Channels
+  g_byte_array_append(wav, (const guint8 *) &value16, 2);
+  value32 = GUINT32_TO_LE(BENCH_WAV_RATE);
+  g_byte_array_append(wav, (const guint8 *) &value32, 4);
+  value32 = GUINT32_TO_LE(BENCH_WAV_RATE * 2); // Bytes per second
+  g_byte_array_append(wav, (const guint8 *) &value32, 4);
+  value16 = GUINT16_TO_LE(2); // Block align
+  g_byte_array_append(wav, (const guint8 *) &value16, 2);
+  value16 = GUINT16_TO_LE(16); // Bits per sample
+  g_byte_array_append(wav, (const guint8 *) &value16, 2);
+  g_byte_array_append(wav, (const guint8 *) "data", 4);
+  value32 = GUINT32_TO_LE(data_size);
+  g_byte_array_append(wav, (const guint8 *) &value32, 4);
+
+  g_byte_array_set_size(wav, wav->len + data_size);
+  memset(wav->data + wav->len - data_size, 0, data_size);
+
+  return g_byte_array_free_to_bytes(wav);
+}
+
+static gboolean cb_bench_http_run(GThreadedSocketService *service, GSocketConnection *connection, GObject *source_object, gpointer user_data)
+{
+  GBytes *wav = user_data;
+  GInputStream *input = g_io_stream_get_input_stream(G_IO_STREAM(connection));
+  GOutputStream *output = g_io_stream_get_output_stream(G_IO_STREAM(connection));
+  const guint8 *data = NULL;
+  gsize size = 0;
+  gsize chunk_size = MAX(http_rate / 10, 1);
+  gsize offset = 0;
+  gchar request[4096];
+  gchar *header = NULL;
+
+  if (g_input_stream_read(input, request, sizeof(request), NULL, NULL) <= 0)
+    return TRUE;
+
+  data = g_bytes_get_data(wav, &size);
+  header = g_strdup_printf("HTTP/1.1 200 OK\r\n"
+                           "Content-Type: audio/x-wav\r\n"
+                           "Content-Length: %" G_GSIZE_FORMAT "\r\n"
+                           "Connection: close\r\n\r\n", size);
+
+  if (g_output_stream_write_all(output, header, strlen(header), NULL, NULL, NULL)) {
+    // A chunk every 100 ms
+    for (offset = 0; offset < size; offset += chunk_size) {
+      if (!g_output_stream_write_all(output, data + offset, MIN(chunk_size, size - offset), NULL, NULL, NULL))
+        break;
+      g_usleep(G_USEC_PER_SEC / 10);
+    }
+  }
+
+  g_free(header);
+  return TRUE;
+}
+
+static GSocketService *bench_http_server_new(GBytes *wav, guint16 *port)
+{
+  GSocketService *service = g_threaded_socket_service_new(4);
+  GInetAddress *loopback = g_inet_address_new_loopback(G_SOCKET_FAMILY_IPV4);
+  GSocketAddress *address = g_inet_socket_address_new(loopback, 0);
+  GSocketAddress *effective_address = NULL;
+  GError *error = NULL;
+
+  if (!g_socket_listener_add_address(G_SOCKET_LISTENER(service), address, G_SOCKET_TYPE_STREAM,
+                                     G_SOCKET_PROTOCOL_TCP, NULL, &effective_address, &error)) {
+    g_printerr("%s\n", error->message);
+    g_error_free(error);
+    g_clear_object(&service);
+    goto out;
+  }
+
+  *port = g_inet_socket_address_get_port(G_INET_SOCKET_ADDRESS(effective_address));
+  g_signal_connect(service, "run", G_CALLBACK(cb_bench_http_run), wav);
+  g_socket_service_start(service);
+
+out:
+  g_clear_object(&effective_address);
+  g_object_unref(address);
+  g_object_unref(loopback);
+
+  return service;
+}
+
+// Results
+static void add_durations(JsonBuilder *builder, const gchar *name, GArray *durations)
+{
+  gint64 total = 0;
+  gint64 min = G_MAXINT64;
+  gint64 max = 0;
+  guint i = 0;
+
+  for (i = 0; i < durations->len; i++) {
+    gint64 duration = g_array_index(durations, gint64, i);
+
+    total += duration;
+    min = MIN(min, duration);
+    max = MAX(max, duration);
+  }
+
+  json_builder_set_member_name(builder, name);
+  json_builder_begin_object(builder);
+
+  json_builder_set_member_name(builder, "samples");
+  json_builder_add_int_value(builder, durations->len);
+
+  if (durations->len > 0) {
+    json_builder_set_member_name(builder, "mean_us");
+    json_builder_add_int_value(builder, total / durations->len);
+    json_builder_set_member_name(builder, "min_us");
+    json_builder_add_int_value(builder, min);
+    json_builder_set_member_name(builder, "max_us");
+    json_builder_add_int_value(builder, max);
+  }
+
+  json_builder_end_object(builder);
+}
+
+static void read_process_status(gint64 *rss_kb, gint64 *n_threads)
+{
+  gchar *status = NULL;
+  gchar **lines = NULL;
+  guint i = 0;
+
+  *rss_kb = -1;
+  *n_threads = -1;
+
+  // Linux only
+  if (!g_file_get_contents("/proc/self/status", &status, NULL, NULL))
+    return;
+
+  lines = g_strsplit(status, "\n", -1);
+  for (i = 0; lines[i] != NULL; i++) {
+    if (g_str_has_prefix(lines[i], "VmRSS:"))
+      *rss_kb = g_ascii_strtoll(lines[i] + strlen("VmRSS:"), NULL, 10);
+    else if (g_str_has_prefix(lines[i], "Threads:"))
+      *n_threads = g_ascii_strtoll(lines[i] + strlen("Threads:"), NULL, 10);
+  }
+
+  g_strfreev(lines);
+  g_free(status);
+}
+
+// Benchmarks
+static void bench_creation(JsonBuilder *builder)
+{
+  GArray *durations = g_array_new(FALSE, FALSE, sizeof(gint64));
+  gint i = 0;
+
+  for (i = 0; i < n_iterations; i++) {
+    BenchPlayer *bench_player = bench_player_alloc();
+    RctGstPlayer *rct_gst_player = NULL;
+    gint64 start_time = g_get_monotonic_time();
+
+    rct_gst_player = bench_player_new(bench_player, FALSE);
+    if (bench_player_wait_loaded(bench_player)) {
+      gint64 duration = g_get_monotonic_time() - start_time;
+      g_array_append_val(durations, duration);
+    }
+
+    bench_player_stop(rct_gst_player);
+  }
+
+  add_durations(builder, "player_creation", durations);
+  g_array_unref(durations);
+}
+
+static void bench_time_to_playing(JsonBuilder *builder)
+{
+  GArray *to_playing = g_array_new(FALSE, FALSE, sizeof(gint64));
+  GArray *switches = g_array_new(FALSE, FALSE, sizeof(gint64));
+  BenchPlayer *bench_player = NULL;
+  RctGstPlayer *rct_gst_player = NULL;
+  gint i = 0;
+
+  for (i = 0; i < n_iterations; i++) {
+    gint64 start_time = 0;
+
+    bench_player = bench_player_alloc();
+    rct_gst_player = bench_player_new(bench_player, FALSE);
+    bench_player_wait_loaded(bench_player);
+
+    start_time = g_get_monotonic_time();
+    bench_player_play(rct_gst_player, bench_player, video_pipeline);
+    if (bench_player_wait_state(bench_player, GST_STATE_PLAYING)) {
+      gint64 duration = g_get_monotonic_time() - start_time;
+      g_array_append_val(to_playing, duration);
+    }
+
+    bench_player_stop(rct_gst_player);
+  }
+
+  // Alternates between two pipelines on the same player
+  bench_player = bench_player_alloc();
+  rct_gst_player = bench_player_new(bench_player, FALSE);
+  bench_player_wait_loaded(bench_player);
+  bench_player_play(rct_gst_player, bench_player, video_pipeline);
+  bench_player_wait_state(bench_player, GST_STATE_PLAYING);
+
+  for (i = 0; i < n_iterations; i++) {
+    gint64 start_time = g_get_monotonic_time();
+
+    bench_player_play(rct_gst_player, bench_player, i % 2 ? video_pipeline : audio_pipeline);
+    if (bench_player_wait_state(bench_player, GST_STATE_PLAYING)) {
+      gint64 duration = g_get_monotonic_time() - start_time;
+      g_array_append_val(switches, duration);
+    }
+  }
+
+  bench_player_stop(rct_gst_player);
+
+  add_durations(builder, "time_to_playing", to_playing);
+  add_durations(builder, "pipeline_switch", switches);
+
+  g_array_unref(to_playing);
+  g_array_unref(switches);
+}
+
+static void bench_element_messages(JsonBuilder *builder, const gchar *name, RctGstMessageFormat format)
+{
+  BenchPlayer *bench_player = bench_player_alloc();
+  RctGstPlayer *rct_gst_player = NULL;
+  guint64 start_count = 0;
+  guint64 end_count = 0;
+  gint64 start_time = 0;
+  gint64 end_time = 0;
+
+  rct_gst_player = bench_player_new(bench_player, FALSE);
+  g_object_set(rct_gst_player,
+               "element_message_format", format,
+               "on_rct_gst_element_message_binary", cb_on_rct_gst_element_message_binary,
+               NULL);
+  bench_player_wait_loaded(bench_player);
+
+  bench_player_play(rct_gst_player, bench_player, level_pipeline);
+  bench_player_wait_state(bench_player, GST_STATE_PLAYING);
+
+  g_mutex_lock(&bench_player->lock);
+  start_count = bench_player->element_messages;
+  g_mutex_unlock(&bench_player->lock);
+  start_time = g_get_monotonic_time();
+
+  g_usleep((gulong) (message_duration * G_USEC_PER_SEC));
+
+  g_mutex_lock(&bench_player->lock);
+  end_count = bench_player->element_messages;
+  g_mutex_unlock(&bench_player->lock);
+  end_time = g_get_monotonic_time();
+
+  bench_player_stop(rct_gst_player);
+
+  json_builder_set_member_name(builder, name);
+  json_builder_begin_object(builder);
+  json_builder_set_member_name(builder, "messages");
+  json_builder_add_int_value(builder, (gint64) (end_count - start_count));
+  json_builder_set_member_name(builder, "messages_per_second");
+  json_builder_add_double_value(builder, (gdouble) (end_count - start_count) * G_USEC_PER_SEC / (end_time - start_time));
+  json_builder_end_object(builder);
+}
+
+static void bench_property_writes(JsonBuilder *builder)
+{
+  BenchPlayer *bench_player = bench_player_alloc();
+  RctGstPlayer *rct_gst_player = NULL;
+  gint64 json_duration = 0;
+  gint64 typed_duration = 0;
+  gint64 start_time = 0;
+  guint64 applied = 0;
+  guint64 elided = 0;
+  gint i = 0;
+
+  rct_gst_player = bench_player_new(bench_player, FALSE);
+  bench_player_wait_loaded(bench_player);
+  bench_player_play(rct_gst_player, bench_player, audio_pipeline);
+  bench_player_wait_state(bench_player, GST_STATE_PLAYING);
+
+  // Every write changes the volume, none of them can be elided
+  start_time = g_get_monotonic_time();
+  for (i = 0; i < n_property_writes; i++) {
+    gchar *properties = g_strdup_printf("{\"volumeControl\":{\"volume\":%f}}", (gdouble) (i % 100) / 100.0);
+
+    rct_gst_player_post_pipeline_properties(rct_gst_player, properties,
+                                            i == n_property_writes - 1 ? cb_command_applied : NULL,
+                                            bench_player);
+    g_free(properties);
+  }
+  if (bench_player_wait_applied(bench_player))
+    json_duration = g_get_monotonic_time() - start_time;
+
+  start_time = g_get_monotonic_time();
+  for (i = 0; i < n_property_writes; i++) {
+    RctGstPropertyBatch *batch = rct_gst_property_batch_new();
+
+    rct_gst_property_batch_add_double(batch, "volumeControl", "volume", (gdouble) (i % 100) / 100.0);
+    rct_gst_player_post_property_batch(rct_gst_player, batch,
+                                       i == n_property_writes - 1 ? cb_command_applied : NULL,
+                                       bench_player);
+  }
+  if (bench_player_wait_applied(bench_player))
+    typed_duration = g_get_monotonic_time() - start_time;
+
+  rct_gst_player_get_property_write_stats(rct_gst_player, &applied, &elided);
+  bench_player_stop(rct_gst_player);
+
+  json_builder_set_member_name(builder, "property_writes");
+  json_builder_begin_object(builder);
+  json_builder_set_member_name(builder, "writes");
+  json_builder_add_int_value(builder, n_property_writes);
+  json_builder_set_member_name(builder, "json_writes_per_second");
+  json_builder_add_double_value(builder, json_duration ? (gdouble) n_property_writes * G_USEC_PER_SEC / json_duration : 0);
+  json_builder_set_member_name(builder, "typed_writes_per_second");
+  json_builder_add_double_value(builder, typed_duration ? (gdouble) n_property_writes * G_USEC_PER_SEC / typed_duration : 0);
+  json_builder_set_member_name(builder, "applied");
+  json_builder_add_int_value(builder, (gint64) applied);
+  json_builder_set_member_name(builder, "elided");
+  json_builder_add_int_value(builder, (gint64) elided);
+  json_builder_end_object(builder);
+}
+
+static void bench_concurrent_players(JsonBuilder *builder, const gchar *name, gboolean use_shared_executor)
+{
+  BenchPlayer **bench_players = g_new0(BenchPlayer *, n_players);
+  RctGstPlayer **rct_gst_players = g_new0(RctGstPlayer *, n_players);
+  gint64 rss_before = 0;
+  gint64 threads_before = 0;
+  gint64 rss_after = 0;
+  gint64 threads_after = 0;
+  gint n_playing = 0;
+  gint i = 0;
+
+  read_process_status(&rss_before, &threads_before);
+
+  for (i = 0; i < n_players; i++) {
+    bench_players[i] = bench_player_alloc();
+    rct_gst_players[i] = bench_player_new(bench_players[i], use_shared_executor);
+    bench_player_play(rct_gst_players[i], bench_players[i], live_pipeline);
+  }
+
+  for (i = 0; i < n_players; i++)
+    n_playing += bench_player_wait_state(bench_players[i], GST_STATE_PLAYING);
+
+  read_process_status(&rss_after, &threads_after);
+
+  for (i = 0; i < n_players; i++)
+    bench_player_stop(rct_gst_players[i]);
+
+  json_builder_set_member_name(builder, name);
+  json_builder_begin_object(builder);
+  json_builder_set_member_name(builder, "players");
+  json_builder_add_int_value(builder, n_players);
+  json_builder_set_member_name(builder, "playing");
+  json_builder_add_int_value(builder, n_playing);
+  json_builder_set_member_name(builder, "rss_kb");
+  json_builder_add_int_value(builder, rss_after);
+  json_builder_set_member_name(builder, "rss_per_player_kb");
+  json_builder_add_int_value(builder, n_players ? (rss_after - rss_before) / n_players : 0);
+  json_builder_set_member_name(builder, "threads");
+  json_builder_add_int_value(builder, threads_after);
+  json_builder_set_member_name(builder, "threads_per_player");
+  json_builder_add_double_value(builder, n_players ? (gdouble) (threads_after - threads_before) / n_players : 0);
+  json_builder_end_object(builder);
+
+  g_free(rct_gst_players);
+  g_free(bench_players);
+}
+
+// Local UDP loopback, the sender running in its own pipeline
+static void bench_live_latency(JsonBuilder *builder, const gchar *name, gboolean live_low_latency)
+{
+  BenchPlayer *bench_player = bench_player_alloc();
+  RctGstPlayer *rct_gst_player = NULL;
+  GstElement *sender = NULL;
+  RctGstPlayerStats *stats = NULL;
+  gboolean live = FALSE;
+  GstClockTime min_latency = GST_CLOCK_TIME_NONE;
+  GstClockTime max_latency = GST_CLOCK_TIME_NONE;
+
+  sender = gst_parse_launch(udp_sender_pipeline, NULL);
+  if (sender == NULL)
+    return;
+
+  rct_gst_player = bench_player_new(bench_player, FALSE);
+  g_object_set(rct_gst_player, "live_low_latency", live_low_latency, NULL);
+  bench_player_wait_loaded(bench_player);
+
+  bench_player_play(rct_gst_player, bench_player, udp_pipeline);
+  gst_element_set_state(sender, GST_STATE_PLAYING);
+  bench_player_wait_state(bench_player, GST_STATE_PLAYING);
+
+  g_usleep((gulong) (message_duration * G_USEC_PER_SEC));
+
+  rct_gst_player_query_latency(rct_gst_player, &live, &min_latency, &max_latency);
+  stats = rct_gst_player_get_stats(rct_gst_player);
+
+  bench_player_stop(rct_gst_player);
+  gst_element_set_state(sender, GST_STATE_NULL);
+  gst_object_unref(sender);
+
+  json_builder_set_member_name(builder, name);
+  json_builder_begin_object(builder);
+  json_builder_set_member_name(builder, "live");
+  json_builder_add_boolean_value(builder, live);
+  json_builder_set_member_name(builder, "query_min_latency_us");
+  json_builder_add_int_value(builder, GST_CLOCK_TIME_IS_VALID(min_latency) ? (gint64) GST_TIME_AS_USECONDS(min_latency) : -1);
+  json_builder_set_member_name(builder, "measured_latency_us");
+  json_builder_add_int_value(builder, GST_CLOCK_TIME_IS_VALID(stats->measured_latency) ? (gint64) GST_TIME_AS_USECONDS(stats->measured_latency) : -1);
+  json_builder_set_member_name(builder, "max_measured_latency_us");
+  json_builder_add_int_value(builder, GST_CLOCK_TIME_IS_VALID(stats->max_measured_latency) ? (gint64) GST_TIME_AS_USECONDS(stats->max_measured_latency) : -1);
+  json_builder_set_member_name(builder, "dropped_frames");
+  json_builder_add_int_value(builder, (gint64) stats->dropped_frames);
+  json_builder_end_object(builder);
+
+  rct_gst_player_stats_free(stats);
+}
+
+// One second clips, each one prerolled while the previous one plays
+static void bench_playlist(JsonBuilder *builder)
+{
+  BenchPlayer *bench_player = bench_player_alloc();
+  RctGstPlayer *rct_gst_player = NULL;
+  gint n_clips = 5;
+  gint i = 0;
+
+  rct_gst_player = bench_player_new(bench_player, FALSE);
+  g_object_set(rct_gst_player,
+               "async_teardown", TRUE,
+               "on_rct_gst_playlist_item", cb_on_rct_gst_playlist_item,
+               "desired_state", GST_STATE_PLAYING,
+               NULL);
+  bench_player_wait_loaded(bench_player);
+
+  for (i = 0; i < n_clips; i++)
+    rct_gst_player_post_playlist_enqueue(rct_gst_player, clip_pipeline, NULL, NULL);
+
+  bench_player_wait_eos(bench_player, BENCH_TIMEOUT);
+  bench_player_stop(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  add_durations(builder, "playlist_gap", bench_player->playlist_gaps);
+  g_mutex_unlock(&bench_player->lock);
+}
+
+// Network source slower than the media : playback pauses to refill instead of stuttering
+static void bench_buffering(JsonBuilder *builder)
+{
+  BenchPlayer *bench_player = bench_player_alloc();
+  RctGstPlayer *rct_gst_player = NULL;
+  GSocketService *service = NULL;
+  GBytes *wav = bench_wav_new();
+  RctGstPlayerStats *stats = NULL;
+  gchar *pipeline = NULL;
+  guint16 port = 0;
+  gint64 start_time = 0;
+  gint64 duration = -1;
+  guint64 buffering_updates = 0;
+
+  service = bench_http_server_new(wav, &port);
+  if (service == NULL)
+    goto out;
+
+  pipeline = g_strdup_printf("uridecodebin uri=http://127.0.0.1:%u/bench.wav ! audioconvert ! fakesink sync=true", port);
+
+  rct_gst_player = bench_player_new(bench_player, FALSE);
+  g_object_set(rct_gst_player, "on_rct_gst_buffering", cb_on_rct_gst_buffering, NULL);
+  bench_player_wait_loaded(bench_player);
+
+  start_time = g_get_monotonic_time();
+  bench_player_play(rct_gst_player, bench_player, pipeline);
+  if (bench_player_wait_eos(bench_player, BENCH_TIMEOUT * 3))
+    duration = g_get_monotonic_time() - start_time;
+
+  stats = rct_gst_player_get_stats(rct_gst_player);
+  bench_player_stop(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  buffering_updates = bench_player->buffering_updates;
+  g_mutex_unlock(&bench_player->lock);
+
+  json_builder_set_member_name(builder, "buffering");
+  json_builder_begin_object(builder);
+  json_builder_set_member_name(builder, "media_duration_us");
+  json_builder_add_int_value(builder, BENCH_WAV_SECONDS * G_USEC_PER_SEC);
+  json_builder_set_member_name(builder, "playback_duration_us");
+  json_builder_add_int_value(builder, duration);
+  json_builder_set_member_name(builder, "rebuffers");
+  json_builder_add_int_value(builder, (gint64) stats->rebuffers);
+  json_builder_set_member_name(builder, "buffering_time_us");
+  json_builder_add_int_value(builder, stats->buffering_time);
+  json_builder_set_member_name(builder, "buffering_updates");
+  json_builder_add_int_value(builder, (gint64) buffering_updates);
+  json_builder_end_object(builder);
+
+  rct_gst_player_stats_free(stats);
+  g_socket_service_stop(service);
+  g_object_unref(service);
+
+out:
+  // Connections may still be writing it : the file is kept until the process exits
+  g_free(pipeline);
+}
+
+// 1080p frames of 3 MB through two queues, produced faster than the sink renders them
+static void bench_memory_budget(JsonBuilder *builder, const gchar *name, guint64 memory_budget)
+{
+  BenchPlayer *bench_player = bench_player_alloc();
+  RctGstPlayer *rct_gst_player = NULL;
+  RctGstPlayerStats *stats = NULL;
+  guint64 reports = 0;
+
+  rct_gst_player = bench_player_new(bench_player, FALSE);
+  g_object_set(rct_gst_player,
+               "memory_budget", memory_budget,
+               "on_rct_gst_memory_budget", cb_on_rct_gst_memory_budget,
+               NULL);
+  bench_player_wait_loaded(bench_player);
+
+  bench_player_play(rct_gst_player, bench_player, hd_pipeline);
+  bench_player_wait_state(bench_player, GST_STATE_PLAYING);
+
+  g_usleep((gulong) (message_duration * G_USEC_PER_SEC));
+
+  stats = rct_gst_player_get_stats(rct_gst_player);
+  bench_player_stop(rct_gst_player);
+
+  g_mutex_lock(&bench_player->lock);
+  reports = bench_player->memory_budget_reports;
+  g_mutex_unlock(&bench_player->lock);
+
+  json_builder_set_member_name(builder, name);
+  json_builder_begin_object(builder);
+  json_builder_set_member_name(builder, "memory_budget");
+  json_builder_add_int_value(builder, (gint64) stats->memory_budget);
+  json_builder_set_member_name(builder, "buffered_bytes");
+  json_builder_add_int_value(builder, (gint64) stats->buffered_bytes);
+  json_builder_set_member_name(builder, "max_buffered_bytes");
+  json_builder_add_int_value(builder, (gint64) stats->max_buffered_bytes);
+  json_builder_set_member_name(builder, "budget_reports");
+  json_builder_add_int_value(builder, (gint64) reports);
+  json_builder_end_object(builder);
+
+  rct_gst_player_stats_free(stats);
+}
+
+static void add_task_pool_stats(JsonBuilder *builder)
+{
+  RctGstTaskPoolStats stats;
+
+  rct_gst_player_get_task_pool_stats(&stats);
+
+  json_builder_set_member_name(builder, "task_pool");
+  json_builder_begin_object(builder);
+  json_builder_set_member_name(builder, "max_threads");
+  json_builder_add_int_value(builder, stats.max_threads);
+  json_builder_set_member_name(builder, "peak_threads");
+  json_builder_add_int_value(builder, stats.peak_threads);
+  json_builder_set_member_name(builder, "tasks");
+  json_builder_add_int_value(builder, (gint64) stats.tasks);
+  json_builder_set_member_name(builder, "overflow_tasks");
+  json_builder_add_int_value(builder, (gint64) stats.overflow_tasks);
+  json_builder_set_member_name(builder, "mean_scheduling_latency_us");
+  json_builder_add_int_value(builder, stats.mean_scheduling_latency);
+  json_builder_set_member_name(builder, "max_scheduling_latency_us");
+  json_builder_add_int_value(builder, stats.max_scheduling_latency);
+  json_builder_end_object(builder);
+}
+
+int main(int argc, char **argv)
+{
+  GOptionContext *option_context = NULL;
+  GError *error = NULL;
+  JsonBuilder *builder = NULL;
+  JsonGenerator *generator = NULL;
+  JsonNode *root = NULL;
+  gchar *results = NULL;
+
+  option_context = g_option_context_new("- RctGstPlayer benchmarks");
+  g_option_context_add_main_entries(option_context, option_entries, NULL);
+  g_option_context_add_group(option_context, gst_init_get_option_group());
+  if (!g_option_context_parse(option_context, &argc, &argv, &error)) {
+    g_printerr("%s\n", error->message);
+    g_error_free(error);
+    return 1;
+  }
+  g_option_context_free(option_context);
+
+  builder = json_builder_new();
+  json_builder_begin_object(builder);
+
+  json_builder_set_member_name(builder, "gstreamer_version");
+  results = gst_version_string();
+  json_builder_add_string_value(builder, results);
+  g_free(results);
+
+  bench_creation(builder);
+  bench_time_to_playing(builder);
+  bench_element_messages(builder, "element_messages_json", RCT_GST_MESSAGE_FORMAT_JSON);
+  bench_element_messages(builder, "element_messages_binary", RCT_GST_MESSAGE_FORMAT_BINARY);
+  bench_property_writes(builder);
+  bench_live_latency(builder, "live_latency_default", FALSE);
+  bench_live_latency(builder, "live_latency_low_latency", TRUE);
+  bench_buffering(builder);
+  bench_playlist(builder);
+  bench_memory_budget(builder, "memory_budget_none", 0);
+  bench_memory_budget(builder, "memory_budget_16mb", 16 * 1024 * 1024);
+  bench_concurrent_players(builder, "concurrent_players", FALSE);
+
+  rct_gst_player_executor_init(4, RCT_GST_EXECUTOR_LEAST_LOADED);
+  bench_concurrent_players(builder, "concurrent_players_shared_executor", TRUE);
+
+  // A live source task per player, and some headroom
+  rct_gst_player_task_pool_init(n_players * 2);
+  bench_concurrent_players(builder, "concurrent_players_task_pool", TRUE);
+  add_task_pool_stats(builder);
+
+  json_builder_end_object(builder);
+
+  generator = json_generator_new();
+  json_generator_set_pretty(generator, TRUE);
+  root = json_builder_get_root(builder);
+  json_generator_set_root(generator, root);
+
+  results = json_generator_to_data(generator, NULL);
+  if (output_path == NULL)
+    g_print("%s\n", results);
+  else if (!g_file_set_contents(output_path, results, -1, &error)) {
+    g_printerr("%s\n", error->message);
+    g_error_free(error);
+  }
+
+  g_free(results);
+  json_node_free(root);
+  g_object_unref(generator);
+  g_object_unref(builder);
+
+  return 0;
+}
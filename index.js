@@ -1,5 +1,5 @@
 import React from 'react';
-import { requireNativeComponent, StyleSheet, View, Animated } from 'react-native';
+import { requireNativeComponent, findNodeHandle, Platform, UIManager, StyleSheet, View, Animated } from 'react-native';
 import PropTypes from 'prop-types';
 import * as utils from './utils';
 
@@ -62,7 +62,8 @@ class RCTGstPlayer extends React.Component {
     onGstElementMessage(event) {
         const { element, message } = event.nativeEvent;
         try {
-            const jsonMessage = JSON.parse(message);
+            // Android decodes binary messages natively, other platforms send JSON
+            const jsonMessage = typeof message === 'string' ? JSON.parse(message) : message;
             if (this.props.onGstElementMessage)
                 this.props.onGstElementMessage(element, jsonMessage)
         } catch (error) {
@@ -72,20 +73,43 @@ class RCTGstPlayer extends React.Component {
 
         
     }
+
+    onGstPipelinePosition(event) {
+        const { position, duration } = event.nativeEvent;
+
+        if (this.props.onGstPipelinePosition)
+            this.props.onGstPipelinePosition(position, duration)
+    }
+
+    // Typed element property, applied without going through the JSON properties prop (Android only)
+    setElementProperty(elementName, propertyName, value) {
+        if (Platform.OS !== 'android' || !this.playerRef)
+            return;
+
+        UIManager.dispatchViewManagerCommand(
+            findNodeHandle(this.playerRef),
+            UIManager.getViewManagerConfig('RCTGstPlayer').Commands.setElementProperty,
+            [elementName, propertyName, value]
+        )
+    }
+
     render() {
         let { overlayOpacity } = this.state;
 
         return (
             <View style={[styles.container, this.props.style]}>
                 <RCTGstPlayerNative
+                    ref={ref => this.playerRef = ref}
                     parseLaunchPipeline={this.props.parseLaunchPipeline}
                     pipelineState={this.props.pipelineState}
                     properties={JSON.stringify(this.state.lastPropertiesDiff)}
+                    positionUpdateInterval={this.props.onGstPipelinePosition ? this.props.positionUpdateInterval : 0}
 
                     onGstPipelineStateChanged={this.onGstPipelineStateChanged.bind(this)}
                     onGstPipelineEOS={this.onGstPipelineEOS.bind(this)}
                     onGstPipelineError={this.onGstPipelineError.bind(this)}
                     onGstElementMessage={this.onGstElementMessage.bind(this)}
+                    onGstPipelinePosition={this.onGstPipelinePosition.bind(this)}
 
                     style={styles.player}
 
@@ -126,12 +150,14 @@ RCTGstPlayer.propTypes = {
     parseLaunchPipeline: PropTypes.string.isRequired,
     pipelineState: PropTypes.number.isRequired,
     properties: PropTypes.object,
+    positionUpdateInterval: PropTypes.number, // Milliseconds
 
     // Pipeline callbacks
     onGstPipelineStateChanged: PropTypes.func,
     onGstPipelineEOS: PropTypes.func,
     onGstPipelineError: PropTypes.func,
-    onGstElementMessage: PropTypes.func
+    onGstElementMessage: PropTypes.func,
+    onGstPipelinePosition: PropTypes.func // Milliseconds, -1 when unknown
 };
 
 RCTGstPlayer.defaultProps = {
@@ -141,7 +167,8 @@ RCTGstPlayer.defaultProps = {
 
     // Pipeline
     pipelineState: 2,
-    properties: {}
+    properties: {},
+    positionUpdateInterval: 250
 };
 
 export default RCTGstPlayer;
\ No newline at end of file
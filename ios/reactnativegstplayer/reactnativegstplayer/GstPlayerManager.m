@@ -33,6 +33,7 @@ RCT_EXPORT_VIEW_PROPERTY(onGstPipelineStateChanged, RCTDirectEventBlock)
 RCT_EXPORT_VIEW_PROPERTY(onGstPipelineEOS, RCTDirectEventBlock)
 RCT_EXPORT_VIEW_PROPERTY(onGstPipelineError, RCTDirectEventBlock)
 RCT_EXPORT_VIEW_PROPERTY(onGstElementMessage, RCTDirectEventBlock)
+RCT_EXPORT_VIEW_PROPERTY(onGstPipelinePosition, RCTDirectEventBlock)
 
 RCT_CUSTOM_VIEW_PROPERTY(parseLaunchPipeline, NSString, GstPlayerView)
 {
@@ -52,6 +53,12 @@ RCT_CUSTOM_VIEW_PROPERTY(properties, NSString, GstPlayerView)
     [view setProperties:properties];
 }
 
+RCT_CUSTOM_VIEW_PROPERTY(positionUpdateInterval, NSNumber, GstPlayerView)
+{
+    NSNumber* positionUpdateInterval = [RCTConvert NSNumber:json];
+    [view setPositionUpdateInterval:positionUpdateInterval];
+}
+
 - (UIView *)view
 {
     return [[GstPlayerView alloc] initWithPlayerIndex:++RCT_GST_PLAYER_INDEX];
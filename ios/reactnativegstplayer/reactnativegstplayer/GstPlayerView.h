@@ -24,12 +24,14 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, strong) NSString *parseLaunchPipeline;
 @property (nonatomic, strong) NSNumber *pipelineState;
 @property (nonatomic, strong) NSString *properties;
+@property (nonatomic, strong) NSNumber *positionUpdateInterval;
 
 // react-native events
 @property (nonatomic, copy) RCTDirectEventBlock onGstPipelineStateChanged;
 @property (nonatomic, copy) RCTDirectEventBlock onGstPipelineEOS;
 @property (nonatomic, copy) RCTDirectEventBlock onGstPipelineError;
 @property (nonatomic, copy) RCTDirectEventBlock onGstElementMessage;
+@property (nonatomic, copy) RCTDirectEventBlock onGstPipelinePosition;
 
 
 - (instancetype)initWithPlayerIndex:(int)playerIndex;
@@ -40,6 +40,8 @@ static void cb_on_gst_player_loaded(RctGstPlayer *gst_player) {
     if ([self->_pipelineState intValue] > -1)
         g_object_set(gst_player, "desired_state", [self->_pipelineState intValue], NULL);
     
+    if ([self->_positionUpdateInterval intValue] > 0)
+        g_object_set(gst_player, "position_update_interval", [self->_positionUpdateInterval unsignedIntValue], NULL);
 }
 
 static void cb_on_gst_pipeline_state_changed(RctGstPlayer *gst_player, GstState new_state, GstState old_state) {
@@ -90,6 +92,17 @@ static void cb_on_gst_element_message(RctGstPlayer *gst_player,
                               });
 }
 
+// Nanoseconds, -1 when unknown. Sent in milliseconds.
+static void cb_on_gst_pipeline_position(RctGstPlayer *gst_player, gint64 position, gint64 duration) {
+    GstPlayerView *self = (__bridge GstPlayerView *)(rct_gst_player_get_user_data(gst_player));
+    
+    if (self.onGstPipelinePosition)
+        self.onGstPipelinePosition(@{
+                                    @"position": [NSNumber numberWithDouble:position < 0 ? -1 : position / 1e6],
+                                    @"duration": [NSNumber numberWithDouble:duration < 0 ? -1 : duration / 1e6]
+                                    });
+}
+
 - (instancetype)initWithPlayerIndex:(int)playerIndex
 {
     self = [super init];
@@ -162,6 +175,16 @@ static void cb_on_gst_element_message(RctGstPlayer *gst_player,
     }
 }
 
+- (void)setPositionUpdateInterval:(NSNumber *)positionUpdateInterval
+{
+    NSLog(@"%@ - Set position update interval : %@", [self getTag], positionUpdateInterval);
+    
+    _positionUpdateInterval = positionUpdateInterval;
+    if (self->playerReady) {
+        g_object_set(self->rct_gst_player, "position_update_interval", [_positionUpdateInterval unsignedIntValue], NULL);
+    }
+}
+
 /**
  View lifecycle
  */
@@ -176,6 +199,7 @@ static void cb_on_gst_element_message(RctGstPlayer *gst_player,
                                               cb_on_gst_pipeline_error,
                                               cb_on_gst_element_message,
                                               (__bridge gpointer)self);
+    g_object_set(self->rct_gst_player, "on_rct_gst_pipeline_position", cb_on_gst_pipeline_position, NULL);
     
     rct_gst_player_start(self->rct_gst_player);
 
@@ -1,8 +1,31 @@
+#include <string.h>
 #include <gst/gstelement.h>
+#include <gst/app/gstappsink.h>
+#include <gst/base/gstbasesink.h>
+#include <gst/video/gstvideodecoder.h>
 #include <gio/gio.h>
 #include <json-glib/json-glib.h>
 #include "gst_player.h"
 
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
+typedef struct _RctGstCommand RctGstCommand;
+typedef struct _RctGstTraceRecord RctGstTraceRecord;
+typedef struct _RctGstPadProbe RctGstPadProbe;
+
+// Bus messages are dispatched highest priority first, element messages last
+typedef enum {
+    RCT_GST_BUS_PRIORITY_HIGH,
+    RCT_GST_BUS_PRIORITY_DEFAULT,
+    RCT_GST_BUS_PRIORITY_LOW,
+    RCT_GST_N_BUS_PRIORITIES
+} RctGstBusPriority;
+
 // Object members
 struct _RctGstPlayer {
     GObject  __unused parent_instance;
@@ -13,7 +36,37 @@ struct _RctGstPlayer {
 
     GThread *thread;
     GMainLoop *loop;
+    GMainContext *context;
     GstPipeline *pipeline;
+    GstBus *bus;
+    GSource *bus_watch;
+
+    // Bus messages queued by the sync handler from any thread, guarded by their lock
+    GMutex bus_queue_lock;
+    GQueue bus_queues[RCT_GST_N_BUS_PRIORITIES];
+
+    // Shared executor
+    gboolean use_shared_executor;
+    gpointer executor_worker;
+
+    // Mutations posted from any thread, applied on the player context (lock-free stack, newest first)
+    RctGstCommand *commands;
+    gint commands_scheduled;
+    gint stopped; // From the stop command on, the commands left are completed without being applied
+
+    // Pipeline cache (most recently used first)
+    GQueue *pipeline_cache;
+    guint pipeline_cache_size;
+    GstState pipeline_cache_state;
+    guint64 pipeline_cache_hits;
+    guint64 pipeline_cache_misses;
+
+    // Diff launch strings and only swap the changed segments
+    gboolean incremental_reconfiguration;
+
+    // Hand old pipelines over to the reaper thread
+    gboolean async_teardown;
+    gint64 last_teardown_duration; // Written by the reaper thread, guarded by stats_lock
 
     // States
     GstState desired_state;
@@ -34,11 +87,456 @@ struct _RctGstPlayer {
     void (*on_rct_gst_element_message)(RctGstPlayer *self, const gchar *element_name,
                                    const gchar *message_details);
 
+    void (*on_rct_gst_pipeline_teardown)(RctGstPlayer *self, gint64 teardown_duration);
+
+    void (*on_rct_gst_element_message_binary)(RctGstPlayer *self, const gchar *element_name,
+                                              const guint8 *message_data, gsize message_size);
+
+    // Element messages encoding
+    RctGstMessageFormat element_message_format;
+    GByteArray *message_buffer;
+
+    // Element messages rate limits, by element or structure name
+    GMutex element_messages_lock;
+    GHashTable *message_throttles;
+
+    // Element messages subscriptions (all messages are delivered when there are none)
+    GPtrArray *message_subscriptions;
+    GArray *message_fields;
+    gint last_subscription_id;
+
+    // Elements and properties resolved for the current pipeline, by element name
+    GHashTable *element_targets;
+    gint element_targets_stale;
+    guint64 property_cache_hits;
+    guint64 property_cache_misses;
+
+    // Property writes batched until the next tick, redundant ones being dropped
+    guint property_batch_interval;
+    gboolean property_batch_frame_aligned;
+    GPtrArray *pending_writes;
+    GSource *property_batch_source;
+    guint64 property_writes_applied;
+    guint64 property_writes_elided;
+
+    // Trace records ring, allocated by the first record
+    gint trace_level;
+    RctGstTraceRecord *trace_records;
+    gint trace_head;
+    gint64 trace_epoch;
+
+    // Statistics : the lock also guards the pipeline pointer against other threads
+    GMutex stats_lock;
+    gint64 start_time;
+    guint64 bus_messages[32];
+    GHashTable *qos_stats;
+    RctGstCallbackStats callback_stats[RCT_GST_N_CALLBACKS];
+    gint64 state_change_durations[GST_STATE_PLAYING + 1];
+    GstState state_change_target;
+    gint64 state_change_start;
+
+    guint stats_interval;
+    GSource *stats_source;
+    void (*on_rct_gst_player_stats)(RctGstPlayer *self, const RctGstPlayerStats *stats);
+
+    // Startup timings of the current pipeline, guarded by stats_lock
+    gint64 startup_origin;
+    RctGstStartupTimings startup_timings;
+    GPtrArray *startup_probes;
+    gint startup_pending;
+    guint startup_generation;
+    gboolean startup_reported;
+    gulong element_added_handler;
+    void (*on_rct_gst_startup_timings)(RctGstPlayer *self, const RctGstStartupTimings *timings);
+
+    // Live low latency profile, applied to the elements of each pipeline as they get added.
+    // Probes, generation and measures are guarded by stats_lock.
+    gboolean live_low_latency;
+    guint live_latency;
+    GPtrArray *latency_probes;
+    guint latency_generation;
+    gulong latency_element_added_handler;
+    GstClockTime measured_latency;
+    GstClockTime max_measured_latency;
+
+    // Memory budget : bytes shared between the queues of the next pipelines, as they get added.
+    // Queues, budget of the current pipeline and buffered bytes are guarded by stats_lock.
+    guint64 memory_budget;
+    guint64 pipeline_memory_budget; // 0 when the current pipeline has none
+    GPtrArray *budget_queues;
+    gulong budget_element_added_handler;
+    GSource *budget_source;
+    guint64 max_buffered_bytes;
+    gboolean over_budget;
+    void (*on_rct_gst_memory_budget)(RctGstPlayer *self, guint64 buffered_bytes, guint64 memory_budget);
+
+    // Buffering : held paused below the low watermark until the high one is reached.
+    // Rebuffers and buffering time are guarded by stats_lock.
+    RctGstBufferingMode buffering_mode;
+    guint buffering_low_watermark;
+    guint buffering_high_watermark;
+    gint buffering_live; // -1 until known
+    gboolean buffering;
+    gint buffering_percent;
+    gint buffering_start_percent;
+    gint64 buffering_start;
+    guint64 rebuffers;
+    gint64 buffering_time;
+    void (*on_rct_gst_buffering)(RctGstPlayer *self, gint percent, gint64 time_to_ready);
+
+    // Playlist : URIs follow each other in one playbin, switched on about-to-finish, other items
+    // are preloaded in a second pipeline. Items, indices, probes and gap are also guarded by stats_lock.
+    GPtrArray *playlist;
+    gint playlist_index; // -1 when no item is playing
+    gint playlist_next;  // Set by about-to-finish, current from the stream start
+    gboolean playlist_loop;
+    gchar *preloaded_launch;
+    GstPipeline *preloaded_pipeline;
+    gulong preloaded_element_added_handler;
+    RctGstPadProbe *preloaded_probe;
+    gboolean playlist_prerolled; // A buffer of the preloaded item reached its sink
+    RctGstPadProbe *playlist_probe; // On the video sink when there is one
+    gboolean playlist_probe_video;
+    gulong playlist_element_added_handler;
+    gulong about_to_finish_handler;
+    gint64 playlist_last_buffer;
+    gboolean playlist_boundary; // Until the first buffer of the next item
+    gint64 playlist_gap;
+    void (*on_rct_gst_playlist_item)(RctGstPlayer *self, guint index, gint64 gap);
+
+    // Position updates, the timer running only while playing
+    guint position_update_interval;
+    guint position_update_threshold;
+    GSource *position_source;
+    gint64 last_position;
+    gint64 last_duration;
+    void (*on_rct_gst_pipeline_position)(RctGstPlayer *self, gint64 position, gint64 duration);
+
+    // Seeks, the pending one being the latest request
+    gboolean seek_in_flight; // Until ASYNC_DONE, an error or a new pipeline
+    gint64 seek_start;
+    gboolean seek_pending;
+    GstClockTime pending_seek_position;
+    RctGstSeekMode pending_seek_mode;
+    gint64 pending_seek_start;
+    guint64 seeks_superseded; // Also guarded by stats_lock, coalesced commands included
+    void (*on_rct_gst_seek_done)(RctGstPlayer *self, gint64 position, gint64 latency);
+
+    // Frame taps, the array being also guarded by stats_lock
+    GPtrArray *frame_taps;
+    gint last_frame_tap_id;
+
+    // Snapshot deliveries attached to the player context, guarded by stats_lock like the context
+    GPtrArray *snapshot_sources;
+
     gpointer user_data;
 } __unused;
 
 G_DEFINE_TYPE(RctGstPlayer, rct_gst_player, G_TYPE_OBJECT)
 
+// Element messages wanted by the application
+typedef struct {
+    guint id;
+    gchar *element_name;
+    gchar *structure_name;
+    GQuark *fields; // 0 terminated whitelist, NULL for all fields
+} RctGstMessageSubscription;
+
+// Latest-wins rate limit of element messages
+typedef struct {
+    RctGstPlayer *self;
+    guint max_per_second;
+
+    gint64 window_start;
+    guint window_count;
+    GstMessage *pending;
+    GSource *flush_source;
+
+    guint64 delivered;
+    guint64 coalesced;
+} RctGstMessageThrottle;
+
+// Commands marshalled onto the player context
+typedef enum {
+    RCT_GST_COMMAND_DESIRED_STATE,
+    RCT_GST_COMMAND_PARSE_LAUNCH_PIPELINE,
+    RCT_GST_COMMAND_DRAWABLE_SURFACE,
+    RCT_GST_COMMAND_PIPELINE_PROPERTIES,
+    RCT_GST_COMMAND_PROPERTY_BATCH,
+    RCT_GST_COMMAND_ELEMENT_MESSAGE_RATE_LIMIT,
+    RCT_GST_COMMAND_SUBSCRIBE,
+    RCT_GST_COMMAND_UNSUBSCRIBE,
+    RCT_GST_COMMAND_STATS_INTERVAL,
+    RCT_GST_COMMAND_ADD_FRAME_TAP,
+    RCT_GST_COMMAND_REMOVE_FRAME_TAP,
+    RCT_GST_COMMAND_SEEK,
+    RCT_GST_COMMAND_POSITION_UPDATE_INTERVAL,
+    RCT_GST_COMMAND_PLAYLIST_ENQUEUE,
+    RCT_GST_COMMAND_PLAYLIST_SKIP,
+    RCT_GST_COMMAND_PLAYLIST_CLEAR,
+    RCT_GST_COMMAND_STOP
+} RctGstCommandType;
+
+struct _RctGstCommand {
+    RctGstCommand *next;
+    RctGstCommandType type;
+
+    GstState state;
+    gchar *string;
+    gpointer pointer;
+    guint value;
+    guint64 position;
+
+    RctGstPlayerCommandCallback callback;
+    gpointer callback_data;
+};
+
+// Shared executor : a fixed pool of threads, each one running its own context
+typedef struct {
+    GThread *thread;
+    GMainContext *context;
+    GMainLoop *loop;
+    guint n_players;
+} RctGstExecutorWorker;
+
+typedef struct {
+    GMutex lock;
+    RctGstExecutorWorker *workers;
+    guint n_workers;
+    guint next_worker;
+    RctGstExecutorPolicy policy;
+} RctGstExecutor;
+
+static RctGstExecutor rct_gst_executor;
+
+// Shared task pool : streaming tasks of every pipeline run on one bounded set of threads
+typedef struct {
+    GstTaskPool parent_instance;
+} RctGstTaskPool;
+
+typedef struct {
+    GstTaskPoolClass parent_class;
+} RctGstTaskPoolClass;
+
+typedef struct {
+    GstTaskPoolFunction func;
+    gpointer user_data;
+    gint64 push_time;
+} RctGstTaskJob;
+
+typedef struct {
+    gint nice;
+    guint64 cpu_mask; // 0 for any CPU
+} RctGstTaskScheduling;
+
+typedef struct {
+    GMutex lock;
+    GstTaskPool *pool;
+    GThreadPool *threads;
+    gint max_threads;
+    RctGstTaskScheduling scheduling[RCT_GST_N_TASK_ROLES];
+
+    guint running; // Pushed and not returned yet
+    guint peak_threads;
+    guint64 tasks;
+    guint64 overflow_tasks;
+    gint64 total_latency;
+    gint64 max_latency;
+
+    // Restored once a thread goes back to the pool
+    gint default_nice;
+#ifdef __linux__
+    cpu_set_t default_affinity;
+#endif
+} RctGstTaskPoolState;
+
+static RctGstTaskPoolState rct_gst_shared_task_pool;
+
+G_DEFINE_TYPE(RctGstTaskPool, rct_gst_task_pool, GST_TYPE_TASK_POOL)
+
+// Resolved element property : the element is owned by its RctGstElementTarget
+typedef struct {
+    GstElement *element;
+    GParamSpec *pspec;
+
+    GValue value;         // Last value written, unset when unknown
+    GValue pending_value; // Waiting for the next tick when pending is set
+    gboolean pending;
+} RctGstPropertyTarget;
+
+typedef struct {
+    GstElement *element;
+    GHashTable *properties; // Property name -> RctGstPropertyTarget
+} RctGstElementTarget;
+
+// Pipelines waiting for the reaper thread
+typedef struct {
+    RctGstPlayer *self;
+    GstPipeline *pipeline;
+} RctGstTeardownJob;
+
+// Cached pipelines, kept built and prerolled for instant switching
+typedef struct {
+    gchar *parse_launch_pipeline;
+    GstPipeline *pipeline;
+} RctGstCachedPipeline;
+
+// Set on pipelines whose elements got the live low latency profile, which they keep once cached
+#define RCT_GST_LOW_LATENCY_KEY "rct-gst-low-latency"
+
+// Latest QoS counters of an element
+typedef struct {
+    guint64 processed;
+    guint64 dropped;
+} RctGstQosStats;
+
+// Buffer probe of a sink : startup ones are removed once the first buffer went through
+struct _RctGstPadProbe {
+    GstPad *pad;
+    gulong probe_id;
+};
+
+// Holds the player while installed, as streaming threads may still call it back
+typedef struct {
+    RctGstPlayer *self;
+    guint generation;
+    RctGstPadProbe *probe;
+} RctGstStartupProbeData;
+
+typedef struct {
+    RctGstPlayer *self;
+    guint generation;
+} RctGstLatencyProbeData;
+
+// Sync handler of a pipeline bus, owned by the bus. The player is only set while it watches it.
+typedef struct {
+    GMutex lock;
+    GstPipeline *pipeline;
+    RctGstPlayer *self;
+    gboolean detached; // Cached and preloaded pipelines : nobody will listen to their messages
+} RctGstBusHandler;
+
+#define RCT_GST_BUS_HANDLER_KEY "rct-gst-bus-handler"
+#define RCT_GST_BUS_DISPATCH_BUDGET 32
+
+// Set on sinks of a preloaded pipeline until it's current
+#define RCT_GST_PREROLL_HIDDEN_KEY "rct-gst-preroll-hidden"
+
+// Frames of an element teed off into an appsink, the lock guarding the mutable members
+typedef struct {
+    gint ref_count;
+    guint id;
+    gchar *element_name;
+    gint64 min_interval; // Microseconds, 0 when the rate isn't limited
+    gint max_in_flight;
+    RctGstFrameTapCallback callback;
+    gpointer user_data;
+    RctGstPlayer *self;
+
+    GMutex lock;
+    gboolean removed;
+    GstElement *appsink; // Armed branch, NULL when there's none in the current pipeline
+    gint in_flight;
+    gint64 last_delivery;
+    guint64 delivered;
+    guint64 dropped;
+} RctGstFrameTap;
+
+// The video frame comes first : consumers only see a GstVideoFrame
+typedef struct {
+    GstVideoFrame video_frame;
+    GstSample *sample;
+    RctGstFrameTap *tap;
+} RctGstTapFrame;
+
+// Branch inserted or removed from an idle probe of the tapped pad
+typedef struct {
+    RctGstPlayer *self;
+    RctGstFrameTap *tap; // Inserted ones only
+    GstPipeline *pipeline;
+    GstElement *tee;
+    GstElement *queue;
+    GstElement *appsink;
+} RctGstTapBranch;
+
+#define RCT_GST_SNAPSHOT_TIMEOUT (5 * GST_SECOND)
+
+// Snapshot of a sample, or thumbnails strip of an URI when uri is set
+typedef struct {
+    RctGstPlayer *self;
+    gint width;
+    gint height;
+    RctGstSnapshotFormat format;
+    gpointer user_data;
+
+    GstSample *sample;
+    GstSample *image;
+    RctGstSnapshotCallback snapshot_callback;
+    GSource *source; // Delivering on the player context
+    gboolean delivered;
+
+    gchar *uri;
+    guint n_thumbnails;
+    GPtrArray *thumbnails; // Encoded samples
+    GArray *positions;
+    RctGstThumbnailsCallback thumbnails_callback;
+} RctGstSnapshotJob;
+
+// Trace records, formatted only when dumped
+#define RCT_GST_TRACE_RECORDS 512 // Power of 2
+
+typedef enum {
+    RCT_GST_TRACE_ERROR,
+    RCT_GST_TRACE_EOS,
+    RCT_GST_TRACE_STATE_CHANGED,
+    RCT_GST_TRACE_PROPERTY,
+    RCT_GST_TRACE_DESIRED_STATE,
+    RCT_GST_TRACE_DRAWABLE_SURFACE,
+    RCT_GST_TRACE_PARSE_LAUNCH_PIPELINE,
+    RCT_GST_TRACE_PIPELINE_CREATED,
+    RCT_GST_TRACE_PIPELINE_REUSED,
+    RCT_GST_TRACE_PIPELINE_RECONFIGURED,
+    RCT_GST_TRACE_PIPELINE_RELEASED,
+    RCT_GST_TRACE_PIPELINE_TEARDOWN,
+    RCT_GST_TRACE_SEGMENT_SWAPPED,
+    RCT_GST_TRACE_LINK_FAILED,
+    RCT_GST_TRACE_FRAME_TAP_ATTACHED,
+    RCT_GST_TRACE_FRAME_TAP_REMOVED,
+    RCT_GST_TRACE_FRAME_TAP_FAILED,
+    RCT_GST_TRACE_SNAPSHOT_FAILED,
+    RCT_GST_TRACE_SEEK,
+    RCT_GST_TRACE_SEEK_FAILED,
+    RCT_GST_TRACE_SEEK_DONE,
+    RCT_GST_TRACE_ELEMENT_TUNED,
+    RCT_GST_TRACE_BUFFERING,
+    RCT_GST_TRACE_BUFFERING_DONE,
+    RCT_GST_TRACE_PLAYLIST_ITEM,
+    RCT_GST_TRACE_PLAYLIST_PRELOADED,
+    RCT_GST_TRACE_MEMORY_BUDGET,
+    RCT_GST_TRACE_PLAYER_LOADED
+} RctGstTraceEvent;
+
+struct _RctGstTraceRecord {
+    gint sequence; // 0 while being written, index + 1 once published
+    guint8 level;
+    guint8 event;
+    gint64 timestamp;
+    gint64 value;
+    gchar element[32];
+    gchar detail[64];
+};
+
+// Arguments are only evaluated when the level is traced
+#define RCT_GST_TRACE(self, level, event, element, value, detail)                 \
+    G_STMT_START {                                                                \
+        if (G_UNLIKELY((gint) (level) <= (self)->trace_level))                    \
+            rct_gst_player_trace((self), (level), (event), (element),             \
+                                 (gint64) (value), (detail));                     \
+    } G_STMT_END
+
+#define RCT_GST_TRACE_STATES(old_state, new_state, pending_state) \
+    ((old_state) | ((new_state) << 8) | ((pending_state) << 16))
+
 // Globals static methods
 static void rct_gst_player_set_debug_tag(RctGstPlayer *self, gchar *parse_launch_pipeline);
 
@@ -49,6 +547,550 @@ static void rct_gst_player_set_desired_state(RctGstPlayer *self, GstState state)
 static void rct_gst_player_set_parse_launch_pipeline(RctGstPlayer *self,
                                                      gchar *parse_launch_pipeline);
 
+static void rct_gst_player_post_command(RctGstPlayer *self, RctGstCommand *command);
+
+static void rct_gst_player_reset_seeks(RctGstPlayer *self);
+
+static void rct_gst_player_discard_commands(RctGstPlayer *self);
+
+static void rct_gst_player_flush_snapshots(RctGstPlayer *self);
+
+static GSource *rct_gst_player_attach_source(RctGstPlayer *self,
+                                             GSource *source,
+                                             GSourceFunc func,
+                                             gpointer data);
+
+static void rct_gst_player_clear_source(GSource **source);
+
+static RctGstBusHandler *rct_gst_player_handle_bus(GstPipeline *pipeline);
+
+static void rct_gst_player_flush_property_writes(RctGstPlayer *self);
+
+static void rct_gst_player_schedule_stats(RctGstPlayer *self);
+
+static void rct_gst_player_schedule_position_updates(RctGstPlayer *self);
+
+static void rct_gst_player_reset_position(RctGstPlayer *self);
+
+static gboolean cb_update_position(gpointer data);
+
+static gboolean rct_gst_element_has_property(GstElement *element, const gchar *property_name);
+
+static void rct_gst_player_apply_latency_profile(RctGstPlayer *self);
+
+static void rct_gst_player_clear_latency_profile(RctGstPlayer *self);
+
+static void rct_gst_player_apply_memory_budget(RctGstPlayer *self);
+
+static void rct_gst_player_clear_memory_budget(RctGstPlayer *self);
+
+static void rct_gst_player_schedule_memory_budget(RctGstPlayer *self);
+
+static gboolean rct_gst_player_advance_playlist(RctGstPlayer *self);
+
+static GstPipeline *rct_gst_player_take_preloaded_pipeline(RctGstPlayer *self,
+                                                           const gchar *parse_launch_pipeline);
+
+static void rct_gst_player_watch_playlist(RctGstPlayer *self);
+
+static void rct_gst_player_unwatch_playlist(RctGstPlayer *self);
+
+// Tracing
+// Any thread can record : each one claims its own slot, then publishes it through its sequence
+static void rct_gst_player_trace(RctGstPlayer *self,
+                                 RctGstTraceLevel level,
+                                 RctGstTraceEvent event,
+                                 const gchar *element,
+                                 gint64 value,
+                                 const gchar *detail) {
+    RctGstTraceRecord *records = NULL;
+    RctGstTraceRecord *record = NULL;
+    guint index = 0;
+
+    records = g_atomic_pointer_get(&self->trace_records);
+    if (records == NULL) {
+        records = g_new0(RctGstTraceRecord, RCT_GST_TRACE_RECORDS);
+
+        if (!g_atomic_pointer_compare_and_exchange(&self->trace_records, NULL, records)) {
+            g_free(records);
+            records = g_atomic_pointer_get(&self->trace_records);
+        }
+    }
+
+    index = (guint) g_atomic_int_add(&self->trace_head, 1);
+    record = &records[index & (RCT_GST_TRACE_RECORDS - 1)];
+
+    g_atomic_int_set(&record->sequence, 0);
+
+    record->level = (guint8) level;
+    record->event = (guint8) event;
+    record->timestamp = g_get_monotonic_time();
+    record->value = value;
+    g_strlcpy(record->element, element ? element : "", sizeof(record->element));
+    g_strlcpy(record->detail, detail ? detail : "", sizeof(record->detail));
+
+    g_atomic_int_set(&record->sequence, (gint) (index + 1));
+}
+
+static void rct_gst_trace_record_format(GString *output, const RctGstTraceRecord *record) {
+    static const gchar *level_names[] = {"NONE", "ERROR", "INFO", "DEBUG"};
+
+    g_string_append_printf(output, "%" G_GINT64_FORMAT ".%06" G_GINT64_FORMAT " %-5s ",
+                           record->timestamp / G_USEC_PER_SEC, record->timestamp % G_USEC_PER_SEC,
+                           level_names[MIN(record->level, G_N_ELEMENTS(level_names) - 1)]);
+
+    switch ((RctGstTraceEvent) record->event) {
+        case RCT_GST_TRACE_ERROR:
+            g_string_append_printf(output, "Error from '%s' : %s", record->element,
+                                   record->detail);
+            break;
+
+        case RCT_GST_TRACE_EOS:
+            g_string_append(output, "EOS");
+            break;
+
+        case RCT_GST_TRACE_STATE_CHANGED:
+            g_string_append_printf(output, "New state from '%s' : %s -> %s (%s pending)",
+                                   record->element,
+                                   gst_element_state_get_name((GstState) (record->value & 0xFF)),
+                                   gst_element_state_get_name((GstState) ((record->value >> 8) & 0xFF)),
+                                   gst_element_state_get_name((GstState) ((record->value >> 16) & 0xFF)));
+            break;
+
+        case RCT_GST_TRACE_PROPERTY:
+            g_string_append_printf(output, "Setting property %s: %" G_GINT64_FORMAT,
+                                   record->element, record->value);
+            break;
+
+        case RCT_GST_TRACE_DESIRED_STATE:
+            g_string_append_printf(output, "Setting pipeline state: %s",
+                                   gst_element_state_get_name((GstState) record->value));
+            break;
+
+        case RCT_GST_TRACE_DRAWABLE_SURFACE:
+            g_string_append_printf(output, "Setting property drawable_surface: 0x%" G_GINT64_MODIFIER "x",
+                                   record->value);
+            break;
+
+        case RCT_GST_TRACE_PARSE_LAUNCH_PIPELINE:
+            g_string_append_printf(output, "Setting property parse_launch_pipeline: %s",
+                                   record->detail);
+            break;
+
+        case RCT_GST_TRACE_PIPELINE_CREATED:
+            g_string_append_printf(output, "Created pipeline '%s'", record->element);
+            break;
+
+        case RCT_GST_TRACE_PIPELINE_REUSED:
+            g_string_append_printf(output, "Reusing cached pipeline '%s'", record->element);
+            break;
+
+        case RCT_GST_TRACE_PIPELINE_RECONFIGURED:
+            g_string_append_printf(output, "Reconfigured pipeline '%s' in place", record->element);
+            break;
+
+        case RCT_GST_TRACE_PIPELINE_RELEASED:
+            g_string_append_printf(output, "Released pipeline '%s'", record->element);
+            break;
+
+        case RCT_GST_TRACE_PIPELINE_TEARDOWN:
+            g_string_append_printf(output, "Pipeline teardown took %" G_GINT64_FORMAT " us",
+                                   record->value);
+            break;
+
+        case RCT_GST_TRACE_SEGMENT_SWAPPED:
+            g_string_append_printf(output, "Swapped %" G_GINT64_FORMAT " element(s) between '%s' and '%s'",
+                                   record->value, record->element, record->detail);
+            break;
+
+        case RCT_GST_TRACE_LINK_FAILED:
+            g_string_append_printf(output, "Unable to link '%s' to '%s'", record->element,
+                                   record->detail);
+            break;
+
+        case RCT_GST_TRACE_FRAME_TAP_ATTACHED:
+            g_string_append_printf(output, "Inserted frame tap '%s' after pad '%s'", record->element,
+                                   record->detail);
+            break;
+
+        case RCT_GST_TRACE_FRAME_TAP_REMOVED:
+            g_string_append_printf(output, "Removed frame tap '%s' from pad '%s'", record->element,
+                                   record->detail);
+            break;
+
+        case RCT_GST_TRACE_FRAME_TAP_FAILED:
+            g_string_append_printf(output, "Unable to tap '%s' (tap %" G_GINT64_FORMAT ") : %s",
+                                   record->element, record->value, record->detail);
+            break;
+
+        case RCT_GST_TRACE_SNAPSHOT_FAILED:
+            g_string_append_printf(output, "Snapshot failed : %s", record->detail);
+            break;
+
+        case RCT_GST_TRACE_SEEK:
+            g_string_append_printf(output, "Seeking to %" GST_TIME_FORMAT,
+                                   GST_TIME_ARGS((GstClockTime) record->value));
+            break;
+
+        case RCT_GST_TRACE_SEEK_FAILED:
+            g_string_append_printf(output, "Unable to seek to %" GST_TIME_FORMAT,
+                                   GST_TIME_ARGS((GstClockTime) record->value));
+            break;
+
+        case RCT_GST_TRACE_SEEK_DONE:
+            g_string_append_printf(output, "Seek done in %" G_GINT64_FORMAT " us", record->value);
+            break;
+
+        case RCT_GST_TRACE_ELEMENT_TUNED:
+            g_string_append_printf(output, "Tuned '%s' for low latency", record->element);
+            break;
+
+        case RCT_GST_TRACE_BUFFERING:
+            g_string_append_printf(output, "Buffering from %" G_GINT64_FORMAT "%%", record->value);
+            break;
+
+        case RCT_GST_TRACE_BUFFERING_DONE:
+            g_string_append_printf(output, "Buffered in %" G_GINT64_FORMAT " us", record->value);
+            break;
+
+        case RCT_GST_TRACE_PLAYLIST_ITEM:
+            g_string_append_printf(output, "Playing playlist item %" G_GINT64_FORMAT, record->value);
+            break;
+
+        case RCT_GST_TRACE_PLAYLIST_PRELOADED:
+            g_string_append_printf(output, "Preloaded '%s'", record->detail);
+            break;
+
+        case RCT_GST_TRACE_MEMORY_BUDGET:
+            g_string_append_printf(output, "Buffering %" G_GINT64_FORMAT " bytes, %s", record->value,
+                                   record->detail);
+            break;
+
+        case RCT_GST_TRACE_PLAYER_LOADED:
+            g_string_append(output, "Player is running on the shared executor");
+            break;
+    }
+
+    g_string_append_c(output, '\n');
+}
+
+gchar *rct_gst_player_dump_trace(RctGstPlayer *self) {
+    RctGstTraceRecord *records = NULL;
+    RctGstTraceRecord record;
+    GString *output = NULL;
+    guint head = 0;
+    guint index = 0;
+
+    output = g_string_new(NULL);
+    g_string_append_printf(output, "%s : Trace records\n", self->debug_tag);
+
+    records = g_atomic_pointer_get(&self->trace_records);
+    if (records == NULL)
+        return g_string_free(output, FALSE);
+
+    head = (guint) g_atomic_int_get(&self->trace_head);
+    index = head > RCT_GST_TRACE_RECORDS ? head - RCT_GST_TRACE_RECORDS : 0;
+
+    // Records being written, or overwritten while copied, are skipped
+    for (; index != head; index++) {
+        RctGstTraceRecord *slot = &records[index & (RCT_GST_TRACE_RECORDS - 1)];
+
+        if (g_atomic_int_get(&slot->sequence) != (gint) (index + 1))
+            continue;
+
+        record = *slot;
+        if (g_atomic_int_get(&slot->sequence) != (gint) (index + 1))
+            continue;
+
+        record.timestamp -= self->trace_epoch;
+        rct_gst_trace_record_format(output, &record);
+    }
+
+    return g_string_free(output, FALSE);
+}
+
+// Statistics accounting
+static void rct_gst_player_account_callback(RctGstPlayer *self,
+                                            RctGstCallbackType callback,
+                                            gint64 start_time) {
+    RctGstCallbackStats *callback_stats = &self->callback_stats[callback];
+    gint64 duration = g_get_monotonic_time() - start_time;
+
+    g_mutex_lock(&self->stats_lock);
+
+    callback_stats->calls++;
+    callback_stats->total_time += duration;
+    callback_stats->max_time = MAX(callback_stats->max_time, duration);
+
+    g_mutex_unlock(&self->stats_lock);
+}
+
+static void rct_gst_player_account_message(RctGstPlayer *self, GstMessage *message) {
+    GstMessageType type = GST_MESSAGE_TYPE(message);
+    RctGstQosStats *qos_stats = NULL;
+    GstFormat format = GST_FORMAT_UNDEFINED;
+    guint64 processed = 0;
+    guint64 dropped = 0;
+    gint bit = 31;
+
+    // Extended types all share the last bit
+    if (!(type & GST_MESSAGE_EXTENDED))
+        bit = g_bit_nth_lsf((gulong) type, -1);
+
+    if (type == GST_MESSAGE_QOS)
+        gst_message_parse_qos_stats(message, &format, &processed, &dropped);
+
+    g_mutex_lock(&self->stats_lock);
+
+    if (bit >= 0)
+        self->bus_messages[bit]++;
+
+    if (type == GST_MESSAGE_QOS && format == GST_FORMAT_BUFFERS) {
+        qos_stats = g_hash_table_lookup(self->qos_stats, GST_OBJECT_NAME(GST_MESSAGE_SRC(message)));
+        if (qos_stats == NULL) {
+            qos_stats = g_malloc0(sizeof(RctGstQosStats));
+            g_hash_table_insert(self->qos_stats,
+                                g_strdup(GST_OBJECT_NAME(GST_MESSAGE_SRC(message))), qos_stats);
+        }
+
+        qos_stats->processed = processed;
+        qos_stats->dropped = dropped;
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+}
+
+// Time taken by the pipeline to reach the desired state, and to reach each state since its launch
+static void rct_gst_player_account_state_change(RctGstPlayer *self,
+                                                GstState new_state,
+                                                GstState pending_state) {
+    gint64 now = g_get_monotonic_time();
+
+    g_mutex_lock(&self->stats_lock);
+
+    if (new_state == self->state_change_target && pending_state == GST_STATE_VOID_PENDING) {
+        self->state_change_durations[new_state] = now - self->state_change_start;
+        self->state_change_target = GST_STATE_VOID_PENDING;
+    }
+
+    if (new_state == GST_STATE_READY && self->startup_timings.ready < 0)
+        self->startup_timings.ready = now - self->startup_origin;
+    else if (new_state == GST_STATE_PAUSED && self->startup_timings.paused < 0)
+        self->startup_timings.paused = now - self->startup_origin;
+    else if (new_state == GST_STATE_PLAYING && self->startup_timings.playing < 0)
+        self->startup_timings.playing = now - self->startup_origin;
+
+    g_mutex_unlock(&self->stats_lock);
+}
+
+// Startup timings
+// Reported once the pipeline is playing and every sink got its first buffer
+static void rct_gst_player_report_startup(RctGstPlayer *self) {
+    RctGstStartupTimings timings;
+    gboolean report = FALSE;
+
+    g_mutex_lock(&self->stats_lock);
+
+    if (!self->startup_reported && self->startup_timings.playing >= 0 && self->startup_pending == 0) {
+        self->startup_reported = TRUE;
+        timings = self->startup_timings;
+        report = TRUE;
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (report && self->on_rct_gst_startup_timings) {
+        gint64 start_time = g_get_monotonic_time();
+
+        self->on_rct_gst_startup_timings(self, &timings);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_STARTUP_TIMINGS, start_time);
+    }
+}
+
+static gboolean cb_report_startup(gpointer data) {
+    rct_gst_player_report_startup((RctGstPlayer *) data);
+    return G_SOURCE_REMOVE;
+}
+
+static GstPadProbeReturn cb_first_buffer(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void) info;
+
+    RctGstStartupProbeData *data = NULL;
+    RctGstPlayer *self = NULL;
+    GstCaps *caps = NULL;
+    const gchar *media_type = "";
+    gint64 now = g_get_monotonic_time();
+    gboolean counted = FALSE;
+
+    data = (RctGstStartupProbeData *) user_data;
+    self = data->self;
+
+    caps = gst_pad_get_current_caps(pad);
+    if (caps && gst_caps_get_size(caps) > 0)
+        media_type = gst_structure_get_name(gst_caps_get_structure(caps, 0));
+
+    g_mutex_lock(&self->stats_lock);
+
+    // Probes of a replaced pipeline don't count anymore, and their slot is gone
+    if (data->generation == self->startup_generation) {
+        if (g_str_has_prefix(media_type, "video/") && self->startup_timings.first_video_buffer < 0)
+            self->startup_timings.first_video_buffer = now - self->startup_origin;
+        else if (g_str_has_prefix(media_type, "audio/") && self->startup_timings.first_audio_buffer < 0)
+            self->startup_timings.first_audio_buffer = now - self->startup_origin;
+
+        data->probe->probe_id = 0;
+        self->startup_pending--;
+        counted = TRUE;
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (caps)
+        gst_caps_unref(caps);
+
+    if (counted && self->context)
+        g_main_context_invoke_full(self->context, G_PRIORITY_DEFAULT, cb_report_startup,
+                                   g_object_ref(self), g_object_unref);
+
+    return GST_PAD_PROBE_REMOVE;
+}
+
+static void rct_gst_startup_probe_data_free(RctGstStartupProbeData *data) {
+    g_object_unref(data->self);
+    g_free(data);
+}
+
+static void rct_gst_player_watch_first_buffer(RctGstPlayer *self, GstElement *sink) {
+    RctGstPadProbe *probe = NULL;
+    RctGstStartupProbeData *data = NULL;
+    GstPad *pad = NULL;
+
+    // Bins holding sinks are flagged as sinks too
+    if (GST_IS_BIN(sink))
+        return;
+
+    pad = gst_element_get_static_pad(sink, "sink");
+    if (pad == NULL)
+        return;
+
+    probe = g_malloc0(sizeof(RctGstPadProbe));
+    probe->pad = pad;
+
+    data = g_malloc0(sizeof(RctGstStartupProbeData));
+    data->self = g_object_ref(self);
+    data->probe = probe;
+
+    // Held while adding, so that the probe can't fire before its id is known
+    g_mutex_lock(&self->stats_lock);
+
+    data->generation = self->startup_generation;
+    probe->probe_id = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, cb_first_buffer, data,
+                                        (GDestroyNotify) rct_gst_startup_probe_data_free);
+    g_ptr_array_add(self->startup_probes, probe);
+    self->startup_pending++;
+
+    g_mutex_unlock(&self->stats_lock);
+}
+
+static void cb_watch_sink(const GValue *item, gpointer user_data) {
+    GstElement *element = GST_ELEMENT(g_value_get_object(item));
+
+    if (GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK))
+        rct_gst_player_watch_first_buffer((RctGstPlayer *) user_data, element);
+}
+
+// Sinks created while starting up (playbin, decodebin...)
+static void cb_deep_element_added(GstBin *bin, GstBin *sub_bin, GstElement *element, gpointer user_data) {
+    (void) sub_bin;
+
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+    gboolean current = FALSE;
+
+    g_mutex_lock(&self->stats_lock);
+    current = GST_ELEMENT(bin) == GST_ELEMENT(self->pipeline) && !self->startup_reported;
+    g_mutex_unlock(&self->stats_lock);
+
+    if (current && GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK))
+        rct_gst_player_watch_first_buffer(self, element);
+}
+
+static void rct_gst_player_clear_startup_probes(RctGstPlayer *self) {
+    GPtrArray *probes = NULL;
+    guint i = 0;
+
+    if (self->element_added_handler) {
+        g_signal_handler_disconnect(self->pipeline, self->element_added_handler);
+        self->element_added_handler = 0;
+    }
+
+    g_mutex_lock(&self->stats_lock);
+
+    self->startup_generation++;
+    self->startup_pending = 0;
+    probes = self->startup_probes;
+    self->startup_probes = g_ptr_array_new();
+
+    g_mutex_unlock(&self->stats_lock);
+
+    for (i = 0; i < probes->len; i++) {
+        RctGstPadProbe *probe = g_ptr_array_index(probes, i);
+
+        if (probe->probe_id)
+            gst_pad_remove_probe(probe->pad, probe->probe_id);
+
+        gst_object_unref(probe->pad);
+        g_free(probe);
+    }
+
+    g_ptr_array_unref(probes);
+}
+
+// Called once the new pipeline is current, launch_time being when it was asked for
+static void rct_gst_player_watch_startup(RctGstPlayer *self, gint64 launch_time) {
+    GstIterator *iterator = NULL;
+
+    g_mutex_lock(&self->stats_lock);
+
+    self->startup_origin = launch_time;
+    self->startup_timings.parsed = g_get_monotonic_time() - launch_time;
+    self->startup_timings.ready = -1;
+    self->startup_timings.paused = -1;
+    self->startup_timings.playing = -1;
+    self->startup_timings.first_video_buffer = -1;
+    self->startup_timings.first_audio_buffer = -1;
+    self->startup_reported = FALSE;
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (self->pipeline == NULL)
+        return;
+
+    iterator = gst_bin_iterate_recurse(GST_BIN(self->pipeline));
+    gst_iterator_foreach(iterator, cb_watch_sink, self);
+    gst_iterator_free(iterator);
+
+    self->element_added_handler = g_signal_connect(self->pipeline, "deep-element-added",
+                                                   G_CALLBACK(cb_deep_element_added), self);
+}
+
+// Reconfigured in place : the pipeline keeps its state, first buffers of its sinks are measured again
+static void rct_gst_player_rewatch_startup(RctGstPlayer *self, gint64 launch_time) {
+    GstState state = GST_STATE_VOID_PENDING;
+
+    rct_gst_player_clear_startup_probes(self);
+    rct_gst_player_watch_startup(self, launch_time);
+
+    gst_element_get_state(GST_ELEMENT(self->pipeline), &state, NULL, 0);
+
+    g_mutex_lock(&self->stats_lock);
+    if (state == GST_STATE_PLAYING)
+        self->startup_timings.playing = self->startup_timings.parsed;
+    g_mutex_unlock(&self->stats_lock);
+
+    // Without any sink to wait for
+    rct_gst_player_report_startup(self);
+}
+
 static void cb_error(GstBus *bus, GstMessage *msg, RctGstPlayer *self) {
     (void) bus;
     (void) self;
@@ -57,16 +1099,21 @@ static void cb_error(GstBus *bus, GstMessage *msg, RctGstPlayer *self) {
     gchar *debug_info;
 
     gst_message_parse_error(msg, &err, &debug_info);
-    g_print("%s : Error received from element '%s' : %s\n",
-              self->debug_tag,
-              GST_OBJECT_NAME(msg->src),
-              err->message);
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_ERROR,
+                  GST_OBJECT_NAME(msg->src), 0, err->message);
+
+    if (self->on_rct_gst_pipeline_error) {
+        gint64 start_time = g_get_monotonic_time();
 
-    if (self->on_rct_gst_pipeline_error)
         self->on_rct_gst_pipeline_error(self,
                                     GST_OBJECT_NAME(msg->src),
                                     err->message,
                                     debug_info);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_ERROR, start_time);
+    }
+
+    // No ASYNC_DONE is coming for a seek in flight
+    rct_gst_player_reset_seeks(self);
 
     g_clear_error(&err);
     g_free(debug_info);
@@ -77,10 +1124,18 @@ static void cb_eos(GstBus *bus, GstMessage *msg, RctGstPlayer *self) {
     (void) msg;
     (void) self;
 
-    g_print("%s : EOS\n", self->debug_tag);
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_EOS, NULL, 0, NULL);
+
+    // Only the end of the playlist is reported
+    if (rct_gst_player_advance_playlist(self))
+        return;
+
+    if (self->on_rct_gst_pipeline_eos) {
+        gint64 start_time = g_get_monotonic_time();
 
-    if (self->on_rct_gst_pipeline_eos)
         self->on_rct_gst_pipeline_eos(self);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_EOS, start_time);
+    }
 }
 
 static void cb_state_changed(GstBus *bus, GstMessage *message, RctGstPlayer *self) {
@@ -89,19 +1144,27 @@ static void cb_state_changed(GstBus *bus, GstMessage *message, RctGstPlayer *sel
     GstState old_state, new_state, pending_state;
     gst_message_parse_state_changed(message, &old_state, &new_state, &pending_state);
 
-    g_print("%s : New state from '%s' : %s -> %s (%s pending)\n",
-           self->debug_tag,
-           GST_ELEMENT_NAME(GST_MESSAGE_SRC(message)),
-           gst_element_state_get_name(old_state),
-           gst_element_state_get_name(new_state),
-           gst_element_state_get_name(pending_state));
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_DEBUG, RCT_GST_TRACE_STATE_CHANGED,
+                  GST_ELEMENT_NAME(GST_MESSAGE_SRC(message)),
+                  RCT_GST_TRACE_STATES(old_state, new_state, pending_state), NULL);
 
     if (GST_MESSAGE_SRC(message) == GST_OBJECT(self->pipeline)) {
+        rct_gst_player_account_state_change(self, new_state, pending_state);
+        if (new_state == GST_STATE_PLAYING)
+            rct_gst_player_report_startup(self);
+
         if (new_state > GST_STATE_READY)
             rct_gst_player_set_drawable_surface(self, self->drawable_surface);
 
-        if (self->on_rct_gst_pipeline_state_changed)
+        if (new_state == GST_STATE_PLAYING || old_state == GST_STATE_PLAYING)
+            rct_gst_player_schedule_position_updates(self);
+
+        if (self->on_rct_gst_pipeline_state_changed) {
+            gint64 start_time = g_get_monotonic_time();
+
             self->on_rct_gst_pipeline_state_changed(self, new_state, old_state);
+            rct_gst_player_account_callback(self, RCT_GST_CALLBACK_STATE_CHANGED, start_time);
+        }
     }
 }
 
@@ -187,291 +1250,5660 @@ static gboolean cb_foreach_element_message_item(GQuark field_id,
     return TRUE;
 }
 
-static gboolean cb_message_element(GstBus *bus, GstMessage *message, RctGstPlayer *self) {
-    (void) bus;
-    (void) message;
-    (void) self;
-
-    if (message->type == GST_MESSAGE_ELEMENT) {
-        JsonBuilder *builder = NULL;
-        JsonGenerator *gen = NULL;
-        JsonNode *root = NULL;
-        gchar *message_details = NULL;
-
-        const GstStructure *message_structure = gst_message_get_structure(message);
-        const gchar *name = gst_structure_get_name(message_structure);
+static void rct_gst_player_deliver_json_message(RctGstPlayer *self,
+                                                const gchar *name,
+                                                const GstStructure *message_structure,
+                                                const GQuark *fields) {
+    JsonBuilder *builder = NULL;
+    JsonGenerator *gen = NULL;
+    JsonNode *root = NULL;
+    gchar *message_details = NULL;
+    const GValue *value = NULL;
 
-        builder = json_builder_new();
-        json_builder_begin_object(builder);
+    builder = json_builder_new();
+    json_builder_begin_object(builder);
 
+    if (fields == NULL) {
         gst_structure_foreach(message_structure, cb_foreach_element_message_item,
                               (gpointer) builder);
+    } else {
+        for (; *fields != 0; fields++) {
+            value = gst_structure_id_get_value(message_structure, *fields);
+            if (value)
+                rct_gst_player_serialize_value(builder, g_quark_to_string(*fields), value);
+        }
+    }
 
-        json_builder_end_object(builder);
+    json_builder_end_object(builder);
 
-        gen = json_generator_new();
-        root = json_builder_get_root(builder);
-        json_generator_set_root(gen, root);
-        message_details = json_generator_to_data(gen, NULL);
+    gen = json_generator_new();
+    root = json_builder_get_root(builder);
+    json_generator_set_root(gen, root);
+    message_details = json_generator_to_data(gen, NULL);
 
-        json_node_free(root);
-        g_object_unref(gen);
-        g_object_unref(builder);
+    json_node_free(root);
+    g_object_unref(gen);
+    g_object_unref(builder);
 
-        
-        if (message_details != NULL) {
-            if (self->on_rct_gst_element_message)
-                self->on_rct_gst_element_message(self, name, message_details);
+    if (message_details != NULL) {
+        if (self->on_rct_gst_element_message) {
+            gint64 start_time = g_get_monotonic_time();
 
-            g_free(message_details);
+            self->on_rct_gst_element_message(self, name, message_details);
+            rct_gst_player_account_callback(self, RCT_GST_CALLBACK_ELEMENT_MESSAGE, start_time);
         }
-    }
 
-    return TRUE;
+        g_free(message_details);
+    }
 }
 
-static gboolean cb_async_done(GstBus *bus, GstMessage *message, RctGstPlayer *self) {
-    (void) bus;
-    (void) message;
-    (void) self;
+// Binary encoding of element messages (see RctGstBinaryType)
+static guint8 rct_gst_player_get_binary_type(GType field_type) {
+    if (field_type == G_TYPE_NONE)
+        return RCT_GST_BINARY_NULL;
 
-    return TRUE;
+    if (field_type == G_TYPE_INT || G_TYPE_IS_ENUM(field_type))
+        return RCT_GST_BINARY_INT32;
+
+    if (field_type == G_TYPE_UINT)
+        return RCT_GST_BINARY_UINT32;
+
+    if (field_type == G_TYPE_INT64)
+        return RCT_GST_BINARY_INT64;
+
+    if (field_type == G_TYPE_UINT64)
+        return RCT_GST_BINARY_UINT64;
+
+    if (field_type == G_TYPE_FLOAT)
+        return RCT_GST_BINARY_FLOAT;
+
+    if (field_type == G_TYPE_DOUBLE)
+        return RCT_GST_BINARY_DOUBLE;
+
+    if (field_type == G_TYPE_BOOLEAN)
+        return RCT_GST_BINARY_BOOLEAN;
+
+    if (field_type == G_TYPE_STRING)
+        return RCT_GST_BINARY_STRING;
+
+    if (field_type == G_TYPE_VALUE_ARRAY || field_type == G_TYPE_ARRAY)
+        return RCT_GST_BINARY_ARRAY;
+
+    return RCT_GST_BINARY_UNSUPPORTED;
 }
 
-// Static callbacks
-static gboolean cb_bus_watch(GstBus *bus, GstMessage *message, gpointer user_data) {
-    RctGstPlayer *self = NULL;
+static void rct_gst_player_encode_value(GByteArray *buffer, const gchar *field_name, const GValue *value) {
+    guint8 binary_type = RCT_GST_BINARY_UNSUPPORTED;
+    guint16 name_length = 0;
+    guint32 length = 0;
+    guint i = 0;
+
+    union {
+        gint32 int32_value;
+        guint32 uint32_value;
+        gint64 int64_value;
+        guint64 uint64_value;
+        gfloat float_value;
+        gdouble double_value;
+        guint8 boolean_value;
+    } payload;
+    gsize payload_size = 0;
+
+    binary_type = rct_gst_player_get_binary_type(G_VALUE_TYPE(value));
+
+    // Unsupported fields are skipped, unsupported array entries become null to keep indexes
+    if (binary_type == RCT_GST_BINARY_UNSUPPORTED) {
+        if (field_name)
+            return;
+
+        binary_type = RCT_GST_BINARY_NULL;
+    }
 
-    self = (RctGstPlayer *) user_data;
+    g_byte_array_append(buffer, &binary_type, 1);
 
-    switch (GST_MESSAGE_TYPE(message)) {
-        case GST_MESSAGE_ERROR:
-            cb_error(bus, message, self);
+    if (field_name) { // None when adding array entry
+        name_length = (guint16) MIN(strlen(field_name), G_MAXUINT16);
+        g_byte_array_append(buffer, (const guint8 *) &name_length, sizeof(name_length));
+        g_byte_array_append(buffer, (const guint8 *) field_name, name_length);
+    }
+
+    switch (binary_type) {
+        case RCT_GST_BINARY_INT32:
+            payload.int32_value = G_VALUE_HOLDS_ENUM(value) ? g_value_get_enum(value) : g_value_get_int(value);
+            payload_size = sizeof(gint32);
             break;
 
-        case GST_MESSAGE_EOS:
-            cb_eos(bus, message, self);
+        case RCT_GST_BINARY_UINT32:
+            payload.uint32_value = g_value_get_uint(value);
+            payload_size = sizeof(guint32);
             break;
 
-        case GST_MESSAGE_STATE_CHANGED:
-            cb_state_changed(bus, message, self);
+        case RCT_GST_BINARY_INT64:
+            payload.int64_value = g_value_get_int64(value);
+            payload_size = sizeof(gint64);
             break;
 
-        case GST_MESSAGE_ELEMENT:
-            cb_message_element(bus, message, self);
+        case RCT_GST_BINARY_UINT64:
+            payload.uint64_value = g_value_get_uint64(value);
+            payload_size = sizeof(guint64);
             break;
 
-        case GST_MESSAGE_ASYNC_DONE:
-            cb_async_done(bus, message, self);
+        case RCT_GST_BINARY_FLOAT:
+            payload.float_value = g_value_get_float(value);
+            payload_size = sizeof(gfloat);
+            break;
+
+        case RCT_GST_BINARY_DOUBLE:
+            payload.double_value = g_value_get_double(value);
+            payload_size = sizeof(gdouble);
+            break;
+
+        case RCT_GST_BINARY_BOOLEAN:
+            payload.boolean_value = (guint8) g_value_get_boolean(value);
+            payload_size = sizeof(guint8);
+            break;
+
+        case RCT_GST_BINARY_STRING: {
+            const gchar *string_value = g_value_get_string(value);
+
+            length = string_value ? (guint32) strlen(string_value) : 0;
+            g_byte_array_append(buffer, (const guint8 *) &length, sizeof(length));
+            g_byte_array_append(buffer, (const guint8 *) string_value, length);
+            break;
+        }
+
+        case RCT_GST_BINARY_ARRAY:
+            if (G_VALUE_TYPE(value) == G_TYPE_VALUE_ARRAY) {
+                GValueArray *value_array = g_value_get_boxed(value);
+
+                length = value_array ? value_array->n_values : 0;
+                g_byte_array_append(buffer, (const guint8 *) &length, sizeof(length));
+                for (i = 0; i < length; i++)
+                    rct_gst_player_encode_value(buffer, NULL, &value_array->values[i]);
+            } else {
+                GArray *value_array = g_value_get_boxed(value);
+
+                length = value_array ? value_array->len : 0;
+                g_byte_array_append(buffer, (const guint8 *) &length, sizeof(length));
+                for (i = 0; i < length; i++)
+                    rct_gst_player_encode_value(buffer, NULL, &g_array_index(value_array, GValue, i));
+            }
             break;
 
         default:
             break;
     }
 
+    if (payload_size > 0)
+        g_byte_array_append(buffer, (const guint8 *) &payload, payload_size);
+}
+
+static gboolean cb_foreach_binary_message_item(GQuark field_id,
+                                               const GValue *value,
+                                               gpointer user_data) {
+    rct_gst_player_encode_value((GByteArray *) user_data, g_quark_to_string(field_id), value);
+
     return TRUE;
 }
 
-// Object methods
-RctGstPlayer *rct_gst_player_new(const gchar *debug_tag,
-                                 const gpointer cb_on_rct_gst_player_loaded,
-                                 const gpointer cb_on_rct_gst_pipeline_state_changed,
-                                 const gpointer cb_on_rct_gst_pipeline_eos,
-                                 const gpointer cb_on_rct_gst_pipeline_error,
-                                 const gpointer cb_on_rct_gst_element_message,
-                                 const gpointer user_data) {
+// The buffer is reused from one message to the next, it is only valid during the callback
+static void rct_gst_player_deliver_binary_message(RctGstPlayer *self,
+                                                  const gchar *name,
+                                                  const GstStructure *message_structure,
+                                                  const GQuark *fields) {
+    const GValue *value = NULL;
+
+    g_byte_array_set_size(self->message_buffer, 0);
+
+    if (fields == NULL) {
+        gst_structure_foreach(message_structure, cb_foreach_binary_message_item,
+                              (gpointer) self->message_buffer);
+    } else {
+        for (; *fields != 0; fields++) {
+            value = gst_structure_id_get_value(message_structure, *fields);
+            if (value)
+                rct_gst_player_encode_value(self->message_buffer, g_quark_to_string(*fields), value);
+        }
+    }
 
-    RctGstPlayer *self = g_object_new(RCT_GST_TYPE_PLAYER,
-                                      "debug_tag", debug_tag,
-                                      "on_rct_gst_player_loaded", cb_on_rct_gst_player_loaded,
-                                      "on_rct_gst_pipeline_state_changed", cb_on_rct_gst_pipeline_state_changed,
-                                      "on_rct_gst_pipeline_eos", cb_on_rct_gst_pipeline_eos,
-                                      "on_rct_gst_pipeline_error", cb_on_rct_gst_pipeline_error,
-                                      "on_rct_gst_element_message", cb_on_rct_gst_element_message,
-                                      "user_data", user_data,
-                                      NULL);
+    if (self->on_rct_gst_element_message_binary) {
+        gint64 start_time = g_get_monotonic_time();
 
-    return self;
+        self->on_rct_gst_element_message_binary(self, name,
+                                                self->message_buffer->data,
+                                                self->message_buffer->len);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_ELEMENT_MESSAGE, start_time);
+    }
 }
 
-gpointer rct_gst_player_get_user_data(RctGstPlayer *self) {
-    return self->user_data;
+// Element messages subscriptions
+static void rct_gst_message_subscription_free(RctGstMessageSubscription *subscription) {
+    g_free(subscription->element_name);
+    g_free(subscription->structure_name);
+    g_free(subscription->fields);
+    g_free(subscription);
 }
 
-// Threading operations
-static gpointer rct_gst_player_run_thread(gpointer data) {
-    RctGstPlayer *self;
+// Returns FALSE when no subscription wants the message. Otherwise, fields is set to the
+// 0 terminated union of the matching whitelists, or to NULL when all fields are wanted.
+static gboolean rct_gst_player_match_subscriptions(RctGstPlayer *self,
+                                                   GstMessage *message,
+                                                   const GQuark **fields) {
+    const gchar *element_name = NULL;
+    const gchar *structure_name = NULL;
+    gboolean matched = FALSE;
+    gboolean all_fields = FALSE;
+    GQuark end_of_fields = 0;
+    guint i = 0;
+    guint j = 0;
+    guint k = 0;
 
-    self = (RctGstPlayer *) data;
-    self->loop = g_main_loop_new(NULL, FALSE);
+    if (fields)
+        *fields = NULL;
 
-    g_print("%s : Player loop is starting...\n", self->debug_tag);
+    if (self->message_subscriptions->len == 0)
+        return TRUE;
 
-    if (self->on_rct_gst_player_loaded)
-        self->on_rct_gst_player_loaded(self);
+    element_name = GST_MESSAGE_SRC(message) ? GST_MESSAGE_SRC_NAME(message) : NULL;
+    structure_name = gst_structure_get_name(gst_message_get_structure(message));
+    g_array_set_size(self->message_fields, 0);
 
-    g_main_loop_run(self->loop);
-    g_print("%s : Player loop is stopping...\n", self->debug_tag);
+    for (i = 0; i < self->message_subscriptions->len; i++) {
+        RctGstMessageSubscription *subscription = g_ptr_array_index(self->message_subscriptions, i);
 
-    return data;
+        if (subscription->element_name && g_strcmp0(subscription->element_name, element_name) != 0)
+            continue;
+
+        if (subscription->structure_name && g_strcmp0(subscription->structure_name, structure_name) != 0)
+            continue;
+
+        matched = TRUE;
+
+        if (subscription->fields == NULL) {
+            all_fields = TRUE;
+            continue;
+        }
+
+        for (j = 0; subscription->fields[j] != 0; j++) {
+            for (k = 0; k < self->message_fields->len; k++) {
+                if (g_array_index(self->message_fields, GQuark, k) == subscription->fields[j])
+                    break;
+            }
+
+            if (k == self->message_fields->len)
+                g_array_append_val(self->message_fields, subscription->fields[j]);
+        }
+    }
+
+    if (matched && fields && !all_fields) {
+        g_array_append_val(self->message_fields, end_of_fields);
+        *fields = (const GQuark *) self->message_fields->data;
+    }
+
+    return matched;
 }
 
-// Thread public starting point
-void rct_gst_player_start(RctGstPlayer *self) {
-    self->thread = g_thread_new("player_thread", rct_gst_player_run_thread, self);
+static void rct_gst_player_apply_subscription(RctGstPlayer *self,
+                                              RctGstMessageSubscription *subscription) {
+    g_ptr_array_add(self->message_subscriptions, subscription);
 }
 
-void rct_gst_player_stop(RctGstPlayer *self) {
-    g_main_loop_quit(self->loop);
+static void rct_gst_player_apply_unsubscription(RctGstPlayer *self, guint subscription_id) {
+    guint i = 0;
+
+    for (i = 0; i < self->message_subscriptions->len; i++) {
+        RctGstMessageSubscription *subscription = g_ptr_array_index(self->message_subscriptions, i);
+
+        if (subscription->id == subscription_id) {
+            g_ptr_array_remove_index(self->message_subscriptions, i);
+            return;
+        }
+    }
 }
 
-// Setters
-static void rct_gst_player_set_debug_tag(RctGstPlayer *self, gchar *parse_launch_pipeline) {
-    self->debug_tag = parse_launch_pipeline;
-    g_print("%s : Setting property debug_tag: %s\n", self->debug_tag, self->debug_tag);
+guint rct_gst_player_subscribe_element_messages(RctGstPlayer *self,
+                                                const gchar *element_name,
+                                                const gchar *structure_name,
+                                                const gchar *const *fields) {
+    RctGstMessageSubscription *subscription = NULL;
+    RctGstCommand *command = NULL;
+    guint subscription_id = 0;
+    guint n_fields = 0;
+    guint i = 0;
+
+    subscription_id = (guint) g_atomic_int_add(&self->last_subscription_id, 1) + 1;
+
+    subscription = g_malloc0(sizeof(RctGstMessageSubscription));
+    subscription->id = subscription_id;
+    subscription->element_name = g_strdup(element_name);
+    subscription->structure_name = g_strdup(structure_name);
+
+    if (fields) {
+        n_fields = g_strv_length((gchar **) fields);
+        subscription->fields = g_new0(GQuark, n_fields + 1);
+
+        for (i = 0; i < n_fields; i++)
+            subscription->fields[i] = g_quark_from_string(fields[i]);
+    }
+
+    command = g_malloc0(sizeof(RctGstCommand));
+    command->type = RCT_GST_COMMAND_SUBSCRIBE;
+    command->pointer = subscription;
+    rct_gst_player_post_command(self, command);
+
+    return subscription_id;
 }
 
-static void rct_gst_player_set_drawable_surface(RctGstPlayer *self, gpointer drawable_surface) {
-    GstElement *video_sink = NULL;
-    GstVideoOverlay *video_overlay = NULL;
+void rct_gst_player_unsubscribe_element_messages(RctGstPlayer *self, guint subscription_id) {
+    RctGstCommand *command = NULL;
 
-    self->drawable_surface = drawable_surface;
-    g_print("%s : Setting property drawable_surface: %p\n", self->debug_tag,
-           self->drawable_surface);
+    command = g_malloc0(sizeof(RctGstCommand));
+    command->type = RCT_GST_COMMAND_UNSUBSCRIBE;
+    command->value = subscription_id;
+    rct_gst_player_post_command(self, command);
+}
 
-    video_sink = gst_bin_get_by_interface(GST_BIN(self->pipeline), GST_TYPE_VIDEO_OVERLAY);
-    video_overlay = GST_VIDEO_OVERLAY(video_sink);
+// fields as matched by rct_gst_player_match_subscriptions, just before
+static void rct_gst_player_deliver_element_message(RctGstPlayer *self,
+                                                   GstMessage *message,
+                                                   const GQuark *fields) {
+    const GstStructure *message_structure = gst_message_get_structure(message);
+    const gchar *name = gst_structure_get_name(message_structure);
+
+    if (self->element_message_format == RCT_GST_MESSAGE_FORMAT_BINARY)
+        rct_gst_player_deliver_binary_message(self, name, message_structure, fields);
+    else
+        rct_gst_player_deliver_json_message(self, name, message_structure, fields);
+}
 
-    if (video_overlay)
-        gst_video_overlay_set_window_handle(video_overlay, (guintptr) self->drawable_surface);
+// Element messages throttling
+static void rct_gst_message_throttle_free(RctGstMessageThrottle *throttle) {
+    rct_gst_player_clear_source(&throttle->flush_source);
+
+    if (throttle->pending)
+        gst_message_unref(throttle->pending);
+
+    g_free(throttle);
+}
+
+static RctGstMessageThrottle *rct_gst_player_lookup_throttle(RctGstPlayer *self, GstMessage *message) {
+    RctGstMessageThrottle *throttle = NULL;
+
+    if (g_hash_table_size(self->message_throttles) == 0)
+        return NULL;
+
+    if (GST_MESSAGE_SRC(message))
+        throttle = g_hash_table_lookup(self->message_throttles, GST_MESSAGE_SRC_NAME(message));
+
+    if (throttle == NULL)
+        throttle = g_hash_table_lookup(self->message_throttles,
+                                       gst_structure_get_name(gst_message_get_structure(message)));
+
+    return throttle;
+}
+
+static gboolean cb_flush_throttled_message(gpointer data) {
+    RctGstMessageThrottle *throttle = NULL;
+    RctGstPlayer *self = NULL;
+    GstMessage *message = NULL;
+    const GQuark *fields = NULL;
+
+    throttle = (RctGstMessageThrottle *) data;
+    self = throttle->self;
+
+    g_mutex_lock(&self->element_messages_lock);
+
+    message = throttle->pending;
+    throttle->pending = NULL;
+
+    g_source_unref(throttle->flush_source);
+    throttle->flush_source = NULL;
+
+    // The flushed message opens the next window
+    throttle->window_start = g_get_monotonic_time();
+    throttle->window_count = 1;
+    throttle->delivered++;
+
+    g_mutex_unlock(&self->element_messages_lock);
+
+    // Subscriptions may have changed while it was held
+    if (message) {
+        if (rct_gst_player_match_subscriptions(self, message, &fields))
+            rct_gst_player_deliver_element_message(self, message, fields);
+
+        gst_message_unref(message);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+// Returns TRUE when the message can be delivered right away, keeps it for later otherwise
+static gboolean rct_gst_player_throttle_element_message(RctGstPlayer *self, GstMessage *message) {
+    RctGstMessageThrottle *throttle = NULL;
+    gboolean deliver = TRUE;
+    gint64 now = 0;
+
+    g_mutex_lock(&self->element_messages_lock);
+
+    throttle = rct_gst_player_lookup_throttle(self, message);
+    if (throttle == NULL)
+        goto done;
+
+    now = g_get_monotonic_time();
+    if (now - throttle->window_start >= G_USEC_PER_SEC) {
+        throttle->window_start = now;
+        throttle->window_count = 0;
+    }
+
+    if (throttle->window_count < throttle->max_per_second) {
+        throttle->window_count++;
+        throttle->delivered++;
+        goto done;
+    }
+
+    deliver = FALSE;
+
+    if (throttle->pending) {
+        throttle->coalesced++;
+        gst_message_unref(throttle->pending);
+    }
+    throttle->pending = gst_message_ref(message);
+
+    if (throttle->flush_source == NULL) {
+        gint64 window_left = throttle->window_start + G_USEC_PER_SEC - now;
+
+        throttle->flush_source = rct_gst_player_attach_source(self,
+                                                              g_timeout_source_new((guint) (window_left / 1000) + 1),
+                                                              cb_flush_throttled_message,
+                                                              throttle);
+    }
+
+done:
+    g_mutex_unlock(&self->element_messages_lock);
+    return deliver;
+}
+
+// Throttles are only created and destroyed on the player context, like their flush sources
+static void rct_gst_player_apply_element_message_rate_limit(RctGstPlayer *self,
+                                                            const gchar *name,
+                                                            guint max_per_second) {
+    RctGstMessageThrottle *throttle = NULL;
+
+    g_mutex_lock(&self->element_messages_lock);
+
+    if (max_per_second == 0) {
+        g_hash_table_remove(self->message_throttles, name);
+
+    } else {
+        throttle = g_hash_table_lookup(self->message_throttles, name);
+
+        if (throttle == NULL) {
+            throttle = g_malloc0(sizeof(RctGstMessageThrottle));
+            throttle->self = self;
+            g_hash_table_insert(self->message_throttles, g_strdup(name), throttle);
+        }
+
+        throttle->max_per_second = max_per_second;
+    }
+
+    g_mutex_unlock(&self->element_messages_lock);
+}
+
+void rct_gst_player_set_element_message_rate_limit(RctGstPlayer *self,
+                                                   const gchar *name,
+                                                   guint max_per_second) {
+    RctGstCommand *command = NULL;
+
+    command = g_malloc0(sizeof(RctGstCommand));
+    command->type = RCT_GST_COMMAND_ELEMENT_MESSAGE_RATE_LIMIT;
+    command->string = g_strdup(name);
+    command->value = max_per_second;
+
+    rct_gst_player_post_command(self, command);
+}
+
+gboolean rct_gst_player_get_element_message_throttle_stats(RctGstPlayer *self,
+                                                           const gchar *name,
+                                                           guint64 *delivered,
+                                                           guint64 *coalesced) {
+    RctGstMessageThrottle *throttle = NULL;
+
+    g_mutex_lock(&self->element_messages_lock);
+
+    throttle = g_hash_table_lookup(self->message_throttles, name);
+    if (throttle) {
+        if (delivered)
+            *delivered = throttle->delivered;
+
+        if (coalesced)
+            *coalesced = throttle->coalesced;
+    }
+
+    g_mutex_unlock(&self->element_messages_lock);
+    return throttle != NULL;
+}
+
+static gboolean cb_message_element(GstBus *bus, GstMessage *message, RctGstPlayer *self) {
+    (void) bus;
+    (void) message;
+    (void) self;
+
+    const GQuark *fields = NULL;
+
+    if (message->type == GST_MESSAGE_ELEMENT) {
+        // Filtered and throttled before any serialization, so that discarded messages cost almost nothing
+        if (rct_gst_player_match_subscriptions(self, message, &fields) &&
+            rct_gst_player_throttle_element_message(self, message))
+            rct_gst_player_deliver_element_message(self, message, fields);
+    }
+
+    return TRUE;
+}
+
+// Buffering
+// Flags of playbin and playbin3 (GstPlayFlags)
+#define RCT_GST_PLAY_FLAG_DOWNLOAD (1 << 7)
+#define RCT_GST_PLAY_FLAG_BUFFERING (1 << 8)
+
+// Progressive HTTP files are downloaded, adaptive manifests streamed, other sources left alone
+static RctGstBufferingMode rct_gst_buffering_mode_for_uri(const gchar *uri) {
+    gchar *scheme = NULL;
+    gchar *path = NULL;
+    RctGstBufferingMode mode = RCT_GST_BUFFERING_NONE;
+
+    scheme = g_uri_parse_scheme(uri);
+    if (scheme == NULL || (g_ascii_strcasecmp(scheme, "http") != 0 && g_ascii_strcasecmp(scheme, "https") != 0))
+        goto out;
+
+    // Without the query nor the fragment
+    path = g_strndup(uri, strcspn(uri, "?#"));
+    if (g_str_has_suffix(path, ".m3u8") || g_str_has_suffix(path, ".mpd") || strstr(path, ".ism") != NULL)
+        mode = RCT_GST_BUFFERING_STREAM;
+    else
+        mode = RCT_GST_BUFFERING_DOWNLOAD;
+
+out:
+    g_free(path);
+    g_free(scheme);
+
+    return mode;
+}
+
+// playbin, uridecodebin and urisourcebin
+static void rct_gst_player_configure_buffering(RctGstPlayer *self, GstElement *element) {
+    RctGstBufferingMode mode = self->buffering_mode;
+    gchar *uri = NULL;
+
+    if (mode == RCT_GST_BUFFERING_NONE || !rct_gst_element_has_property(element, "uri"))
+        return;
+
+    g_object_get(element, "uri", &uri, NULL);
+    if (mode == RCT_GST_BUFFERING_AUTO)
+        mode = uri ? rct_gst_buffering_mode_for_uri(uri) : RCT_GST_BUFFERING_NONE;
+    g_free(uri);
+
+    if (mode == RCT_GST_BUFFERING_NONE)
+        return;
+
+    if (rct_gst_element_has_property(element, "flags") &&
+        rct_gst_element_has_property(element, "buffer-duration")) {
+        guint flags = 0;
+
+        g_object_get(element, "flags", &flags, NULL);
+        flags |= RCT_GST_PLAY_FLAG_BUFFERING;
+        if (mode == RCT_GST_BUFFERING_DOWNLOAD)
+            flags |= RCT_GST_PLAY_FLAG_DOWNLOAD;
+        else
+            flags &= ~RCT_GST_PLAY_FLAG_DOWNLOAD;
+        g_object_set(element, "flags", flags, NULL);
+        return;
+    }
+
+    if (rct_gst_element_has_property(element, "use-buffering"))
+        g_object_set(element, "use-buffering", TRUE, NULL);
+    if (rct_gst_element_has_property(element, "download"))
+        g_object_set(element, "download", mode == RCT_GST_BUFFERING_DOWNLOAD, NULL);
+}
+
+static void cb_configure_buffering(const GValue *item, gpointer user_data) {
+    rct_gst_player_configure_buffering((RctGstPlayer *) user_data, GST_ELEMENT(g_value_get_object(item)));
+}
+
+// Called once the new pipeline is current, which is playbin itself when launched alone
+static void rct_gst_player_apply_buffering_mode(RctGstPlayer *self) {
+    GstIterator *iterator = NULL;
+
+    if (self->pipeline == NULL)
+        return;
+
+    rct_gst_player_configure_buffering(self, GST_ELEMENT(self->pipeline));
+
+    iterator = gst_bin_iterate_recurse(GST_BIN(self->pipeline));
+    gst_iterator_foreach(iterator, cb_configure_buffering, self);
+    gst_iterator_free(iterator);
+}
+
+static void rct_gst_player_finish_buffering(RctGstPlayer *self) {
+    gint64 duration = g_get_monotonic_time() - self->buffering_start;
+
+    self->buffering = FALSE;
+
+    g_mutex_lock(&self->stats_lock);
+    self->buffering_time += duration;
+    g_mutex_unlock(&self->stats_lock);
+
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_BUFFERING_DONE, NULL, duration, NULL);
+}
+
+static void rct_gst_player_reset_buffering(RctGstPlayer *self) {
+    if (self->buffering)
+        rct_gst_player_finish_buffering(self);
+
+    self->buffering_live = -1;
+    self->buffering_percent = -1;
+}
+
+// Microseconds until the high watermark : from the queue estimate when there is one,
+// from the fill rate since buffering started otherwise. -1 when unknown.
+static gint64 rct_gst_player_estimate_time_to_ready(RctGstPlayer *self,
+                                                    gint percent,
+                                                    gint64 buffering_left) {
+    gint high_watermark = (gint) self->buffering_high_watermark;
+
+    if (percent >= high_watermark)
+        return 0;
+
+    if (buffering_left >= 0)
+        return buffering_left * 1000;
+
+    if (!self->buffering || percent <= self->buffering_start_percent)
+        return -1;
+
+    return (g_get_monotonic_time() - self->buffering_start) * (high_watermark - percent) /
+           (percent - self->buffering_start_percent);
+}
+
+static gboolean cb_buffering(GstBus *bus, GstMessage *message, RctGstPlayer *self) {
+    (void) bus;
+
+    gint percent = 0;
+    gint64 buffering_left = -1;
+    gint64 time_to_ready = -1;
+    gint64 start_time = 0;
+
+    if (self->buffering_mode == RCT_GST_BUFFERING_NONE || self->pipeline == NULL)
+        return TRUE;
+
+    // Live pipelines can't be paused to refill, they would only fall behind
+    if (self->buffering_live < 0) {
+        GstQuery *query = gst_query_new_latency();
+        gboolean live = FALSE;
+
+        if (gst_element_query(GST_ELEMENT(self->pipeline), query)) {
+            gst_query_parse_latency(query, &live, NULL, NULL);
+            self->buffering_live = live;
+        }
+        gst_query_unref(query);
+    }
+
+    if (self->buffering_live > 0)
+        return TRUE;
+
+    gst_message_parse_buffering(message, &percent);
+    gst_message_parse_buffering_stats(message, NULL, NULL, NULL, &buffering_left);
+
+    if (!self->buffering && percent < (gint) self->buffering_low_watermark) {
+        self->buffering = TRUE;
+        self->buffering_start = g_get_monotonic_time();
+        self->buffering_start_percent = percent;
+
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_BUFFERING, NULL, percent, NULL);
+
+        // Buffering after having played is a stall, the one of the startup isn't
+        g_mutex_lock(&self->stats_lock);
+        if (self->startup_timings.playing >= 0)
+            self->rebuffers++;
+        g_mutex_unlock(&self->stats_lock);
+
+        if (self->desired_state == GST_STATE_PLAYING)
+            gst_element_set_state(GST_ELEMENT(self->pipeline), GST_STATE_PAUSED);
+
+    } else if (self->buffering && percent >= (gint) self->buffering_high_watermark) {
+        rct_gst_player_finish_buffering(self);
+
+        if (self->desired_state == GST_STATE_PLAYING)
+            gst_element_set_state(GST_ELEMENT(self->pipeline), GST_STATE_PLAYING);
+    }
+
+    time_to_ready = rct_gst_player_estimate_time_to_ready(self, percent, buffering_left);
+
+    if (percent != self->buffering_percent && self->on_rct_gst_buffering) {
+        start_time = g_get_monotonic_time();
+        self->on_rct_gst_buffering(self, percent, time_to_ready);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_BUFFERING, start_time);
+    }
+
+    self->buffering_percent = percent;
+
+    return TRUE;
+}
+
+// Seeks
+// One flushing seek in flight at a time : requests made meanwhile replace each other
+static GstSeekFlags rct_gst_seek_mode_get_flags(RctGstSeekMode mode) {
+    switch (mode) {
+        case RCT_GST_SEEK_KEY_UNIT:
+            return GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT;
+
+        case RCT_GST_SEEK_SNAP:
+            return GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT | GST_SEEK_FLAG_SNAP_NEAREST;
+
+        case RCT_GST_SEEK_ACCURATE:
+        default:
+            return GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE;
+    }
+}
+
+static void rct_gst_player_start_seek(RctGstPlayer *self) {
+    self->seek_pending = FALSE;
+
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_SEEK, NULL,
+                  self->pending_seek_position, NULL);
+
+    if (!gst_element_seek_simple(GST_ELEMENT(self->pipeline), GST_FORMAT_TIME,
+                                 rct_gst_seek_mode_get_flags(self->pending_seek_mode),
+                                 (gint64) self->pending_seek_position)) {
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_SEEK_FAILED, NULL,
+                      self->pending_seek_position, NULL);
+        // Dropped : the next request starts right away instead of waiting for an ASYNC_DONE
+        self->seek_in_flight = FALSE;
+        return;
+    }
+
+    self->seek_in_flight = TRUE;
+    self->seek_start = self->pending_seek_start;
+}
+
+// Seeks wait for the pipeline to be prerolled, and for the previous seek to be done
+static void rct_gst_player_seek(RctGstPlayer *self, GstClockTime position, RctGstSeekMode mode) {
+    GstState state = GST_STATE_VOID_PENDING;
+
+    if (self->seek_pending) {
+        g_mutex_lock(&self->stats_lock);
+        self->seeks_superseded++;
+        g_mutex_unlock(&self->stats_lock);
+    }
+
+    self->seek_pending = TRUE;
+    self->pending_seek_position = position;
+    self->pending_seek_mode = mode;
+    self->pending_seek_start = g_get_monotonic_time();
+
+    if (self->pipeline == NULL || self->seek_in_flight)
+        return;
+
+    // Not blocking : the state is only looked at
+    gst_element_get_state(GST_ELEMENT(self->pipeline), &state, NULL, 0);
+    if (state >= GST_STATE_PAUSED)
+        rct_gst_player_start_seek(self);
+}
+
+static void rct_gst_player_reset_seeks(RctGstPlayer *self) {
+    self->seek_in_flight = FALSE;
+    self->seek_pending = FALSE;
+}
+
+static void rct_gst_player_complete_seek(RctGstPlayer *self) {
+    gint64 position = -1;
+    gint64 latency = 0;
+    gint64 start_time = 0;
+
+    if (self->seek_in_flight) {
+        self->seek_in_flight = FALSE;
+        latency = g_get_monotonic_time() - self->seek_start;
+
+        // Where the seek landed, which differs from the request with key units
+        gst_element_query_position(GST_ELEMENT(self->pipeline), GST_FORMAT_TIME, &position);
+
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_SEEK_DONE, NULL, latency, NULL);
+
+        // Reported right away, a paused pipeline having no ticks
+        rct_gst_player_reset_position(self);
+        if (self->position_update_interval > 0)
+            cb_update_position(self);
+
+        if (self->on_rct_gst_seek_done) {
+            start_time = g_get_monotonic_time();
+            self->on_rct_gst_seek_done(self, position, latency);
+            rct_gst_player_account_callback(self, RCT_GST_CALLBACK_SEEK_DONE, start_time);
+        }
+    }
+
+    if (self->seek_pending && self->pipeline)
+        rct_gst_player_start_seek(self);
+}
+
+static gboolean cb_async_done(GstBus *bus, GstMessage *message, RctGstPlayer *self) {
+    (void) bus;
+    (void) message;
+
+    // Flushing seeks and prerolls are both done once the pipeline is prerolled again
+    if (GST_MESSAGE_SRC(message) == GST_OBJECT(self->pipeline))
+        rct_gst_player_complete_seek(self);
+
+    return TRUE;
+}
+
+// Static callbacks
+static gboolean cb_bus_watch(GstBus *bus, GstMessage *message, gpointer user_data) {
+    RctGstPlayer *self = NULL;
+
+    self = (RctGstPlayer *) user_data;
+
+    switch (GST_MESSAGE_TYPE(message)) {
+        case GST_MESSAGE_ERROR:
+            cb_error(bus, message, self);
+            break;
+
+        case GST_MESSAGE_EOS:
+            cb_eos(bus, message, self);
+            break;
+
+        case GST_MESSAGE_STATE_CHANGED:
+            cb_state_changed(bus, message, self);
+            break;
+
+        case GST_MESSAGE_ELEMENT:
+            cb_message_element(bus, message, self);
+            break;
+
+        case GST_MESSAGE_ASYNC_DONE:
+            cb_async_done(bus, message, self);
+            break;
+
+        case GST_MESSAGE_BUFFERING:
+            cb_buffering(bus, message, self);
+            break;
+
+        default:
+            break;
+    }
+
+    return TRUE;
+}
+
+// Object methods
+RctGstPlayer *rct_gst_player_new(const gchar *debug_tag,
+                                 const gpointer cb_on_rct_gst_player_loaded,
+                                 const gpointer cb_on_rct_gst_pipeline_state_changed,
+                                 const gpointer cb_on_rct_gst_pipeline_eos,
+                                 const gpointer cb_on_rct_gst_pipeline_error,
+                                 const gpointer cb_on_rct_gst_element_message,
+                                 const gpointer user_data) {
+
+    RctGstPlayer *self = g_object_new(RCT_GST_TYPE_PLAYER,
+                                      "debug_tag", debug_tag,
+                                      "on_rct_gst_player_loaded", cb_on_rct_gst_player_loaded,
+                                      "on_rct_gst_pipeline_state_changed", cb_on_rct_gst_pipeline_state_changed,
+                                      "on_rct_gst_pipeline_eos", cb_on_rct_gst_pipeline_eos,
+                                      "on_rct_gst_pipeline_error", cb_on_rct_gst_pipeline_error,
+                                      "on_rct_gst_element_message", cb_on_rct_gst_element_message,
+                                      "user_data", user_data,
+                                      NULL);
+
+    return self;
+}
+
+gpointer rct_gst_player_get_user_data(RctGstPlayer *self) {
+    return self->user_data;
+}
+
+// Sources
+// Watches and timers are attached to the player's own context, never to the default one
+static GSource *rct_gst_player_attach_source(RctGstPlayer *self,
+                                             GSource *source,
+                                             GSourceFunc func,
+                                             gpointer data) {
+    g_source_set_callback(source, func, data, NULL);
+    g_source_attach(source, self->context);
+
+    return source;
+}
+
+static void rct_gst_player_clear_source(GSource **source) {
+    if (*source == NULL)
+        return;
+
+    g_source_destroy(*source);
+    g_source_unref(*source);
+    *source = NULL;
+}
+
+// Bus messages
+// Window handles, QoS and latency are handled on the posting thread, the rest is queued
+static gboolean rct_gst_message_is_fast_path(GstMessage *message) {
+    switch (GST_MESSAGE_TYPE(message)) {
+        case GST_MESSAGE_QOS:
+        case GST_MESSAGE_LATENCY:
+        case GST_MESSAGE_STREAM_STATUS:
+            return TRUE;
+
+        case GST_MESSAGE_ELEMENT:
+            return gst_is_video_overlay_prepare_window_handle_message(message);
+
+        default:
+            return FALSE;
+    }
+}
+
+// A burst of element or buffering messages never delays an error, an EOS or a state change
+static RctGstBusPriority rct_gst_message_get_priority(GstMessage *message) {
+    switch (GST_MESSAGE_TYPE(message)) {
+        case GST_MESSAGE_ERROR:
+        case GST_MESSAGE_EOS:
+        case GST_MESSAGE_STATE_CHANGED:
+        case GST_MESSAGE_ASYNC_DONE:
+            return RCT_GST_BUS_PRIORITY_HIGH;
+
+        case GST_MESSAGE_ELEMENT:
+            return RCT_GST_BUS_PRIORITY_LOW;
+
+        default:
+            return RCT_GST_BUS_PRIORITY_DEFAULT;
+    }
+}
+
+static void rct_gst_player_queue_message(RctGstPlayer *self, GstMessage *message) {
+    g_mutex_lock(&self->bus_queue_lock);
+    g_queue_push_tail(&self->bus_queues[rct_gst_message_get_priority(message)], gst_message_ref(message));
+    g_mutex_unlock(&self->bus_queue_lock);
+
+    g_source_set_ready_time(self->bus_watch, 0);
+}
+
+static GstMessage *rct_gst_player_pop_message(RctGstPlayer *self) {
+    GstMessage *message = NULL;
+    guint i = 0;
+
+    g_mutex_lock(&self->bus_queue_lock);
+    for (i = 0; i < RCT_GST_N_BUS_PRIORITIES && message == NULL; i++)
+        message = g_queue_pop_head(&self->bus_queues[i]);
+    g_mutex_unlock(&self->bus_queue_lock);
+
+    return message;
+}
+
+static void rct_gst_player_clear_messages(RctGstPlayer *self) {
+    GstMessage *message = NULL;
+    guint i = 0;
+
+    g_mutex_lock(&self->bus_queue_lock);
+    for (i = 0; i < RCT_GST_N_BUS_PRIORITIES; i++) {
+        while ((message = g_queue_pop_head(&self->bus_queues[i])))
+            gst_message_unref(message);
+    }
+    g_mutex_unlock(&self->bus_queue_lock);
+}
+
+// Called from the posting thread, or from the player context for messages posted while unwatched
+static GstBusSyncReply rct_gst_bus_handler_receive(RctGstBusHandler *handler, GstMessage *message) {
+    gboolean watched = FALSE;
+    gboolean detached = FALSE;
+    gpointer drawable_surface = NULL;
+
+    g_mutex_lock(&handler->lock);
+
+    watched = handler->self != NULL;
+    detached = handler->detached;
+    if (watched) {
+        rct_gst_player_account_message(handler->self, message);
+        drawable_surface = handler->self->drawable_surface;
+
+        if (!rct_gst_message_is_fast_path(message))
+            rct_gst_player_queue_message(handler->self, message);
+    }
+
+    g_mutex_unlock(&handler->lock);
+
+    // Left on the bus until a player watches it
+    if (!watched)
+        return detached ? GST_BUS_DROP : GST_BUS_PASS;
+
+    switch (GST_MESSAGE_TYPE(message)) {
+        case GST_MESSAGE_ELEMENT:
+            // Bound before the sink goes on, instead of it opening its own window
+            if (drawable_surface && gst_is_video_overlay_prepare_window_handle_message(message))
+                gst_video_overlay_set_window_handle(GST_VIDEO_OVERLAY(GST_MESSAGE_SRC(message)),
+                                                    (guintptr) drawable_surface);
+            break;
+
+        case GST_MESSAGE_LATENCY:
+            gst_bin_recalculate_latency(GST_BIN(handler->pipeline));
+            break;
+
+        default:
+            break;
+    }
+
+    return GST_BUS_DROP;
+}
+
+static gboolean cb_dispatch_bus_source(GSource *source, GSourceFunc callback, gpointer user_data) {
+    g_source_set_ready_time(source, -1);
+
+    return callback(user_data);
+}
+
+static GSourceFuncs rct_gst_bus_source_funcs = {NULL, NULL, cb_dispatch_bus_source, NULL, NULL, NULL};
+
+static gboolean cb_dispatch_messages(gpointer user_data) {
+    RctGstPlayer *self = NULL;
+    GstMessage *message = NULL;
+    guint dispatched = 0;
+
+    self = (RctGstPlayer *) user_data;
+
+    // Bounded, so that a flood doesn't starve the other sources of the context
+    for (dispatched = 0; dispatched < RCT_GST_BUS_DISPATCH_BUDGET; dispatched++) {
+        message = rct_gst_player_pop_message(self);
+        if (message == NULL)
+            return G_SOURCE_CONTINUE;
+
+        cb_bus_watch(self->bus, message, self);
+        gst_message_unref(message);
+    }
+
+    // The callbacks may have swapped the pipeline, and its watch
+    if (self->bus_watch)
+        g_source_set_ready_time(self->bus_watch, 0);
+
+    return G_SOURCE_CONTINUE;
+}
+
+static GSource *rct_gst_player_create_bus_watch(RctGstPlayer *self) {
+    return rct_gst_player_attach_source(self,
+                                        g_source_new(&rct_gst_bus_source_funcs, sizeof(GSource)),
+                                        cb_dispatch_messages,
+                                        (gpointer) self);
+}
+
+static void rct_gst_player_watch_bus(RctGstPlayer *self) {
+    RctGstBusHandler *handler = NULL;
+    GstMessage *message = NULL;
+
+    // The launch string failed to parse
+    if (self->pipeline == NULL)
+        return;
+
+    handler = rct_gst_player_handle_bus(self->pipeline);
+
+    self->bus = gst_pipeline_get_bus(self->pipeline);
+    self->bus_watch = rct_gst_player_create_bus_watch(self);
+
+    g_mutex_lock(&handler->lock);
+    handler->self = self;
+    handler->detached = FALSE;
+    g_mutex_unlock(&handler->lock);
+
+    // Posted between the launch and the watch
+    while ((message = gst_bus_pop(self->bus))) {
+        rct_gst_bus_handler_receive(handler, message);
+        gst_message_unref(message);
+    }
+}
+
+// Unlike flushing the bus, stream status messages still reach the task pool
+static void rct_gst_player_detach_bus(GstPipeline *pipeline) {
+    RctGstBusHandler *handler = NULL;
+
+    handler = rct_gst_player_handle_bus(pipeline);
+
+    g_mutex_lock(&handler->lock);
+    handler->detached = TRUE;
+    g_mutex_unlock(&handler->lock);
+}
+
+// Moves the watch to the player's context, keeping the queued messages
+static void rct_gst_player_rewatch_bus(RctGstPlayer *self) {
+    RctGstBusHandler *handler = NULL;
+
+    handler = g_object_get_data(G_OBJECT(self->bus), RCT_GST_BUS_HANDLER_KEY);
+
+    g_mutex_lock(&handler->lock);
+    rct_gst_player_clear_source(&self->bus_watch);
+    self->bus_watch = rct_gst_player_create_bus_watch(self);
+    g_source_set_ready_time(self->bus_watch, 0);
+    g_mutex_unlock(&handler->lock);
+}
+
+static void rct_gst_player_unwatch_bus(RctGstPlayer *self) {
+    RctGstBusHandler *handler = NULL;
+
+    if (self->bus) {
+        handler = g_object_get_data(G_OBJECT(self->bus), RCT_GST_BUS_HANDLER_KEY);
+
+        g_mutex_lock(&handler->lock);
+        handler->self = NULL;
+        g_mutex_unlock(&handler->lock);
+
+        gst_object_unref(self->bus);
+        self->bus = NULL;
+    }
+
+    rct_gst_player_clear_source(&self->bus_watch);
+    rct_gst_player_clear_messages(self);
+}
+
+// Shared executor
+static gpointer rct_gst_executor_run_worker(gpointer data) {
+    RctGstExecutorWorker *worker = NULL;
+
+    worker = (RctGstExecutorWorker *) data;
+
+    g_main_context_push_thread_default(worker->context);
+    g_main_loop_run(worker->loop);
+    g_main_context_pop_thread_default(worker->context);
+
+    return data;
+}
+
+gboolean rct_gst_player_executor_init(guint n_workers, RctGstExecutorPolicy policy) {
+    guint i = 0;
+
+    g_mutex_lock(&rct_gst_executor.lock);
+
+    if (rct_gst_executor.workers != NULL || n_workers == 0) {
+        g_mutex_unlock(&rct_gst_executor.lock);
+        return FALSE;
+    }
+
+    rct_gst_executor.workers = g_new0(RctGstExecutorWorker, n_workers);
+    rct_gst_executor.n_workers = n_workers;
+    rct_gst_executor.next_worker = 0;
+    rct_gst_executor.policy = policy;
+
+    for (i = 0; i < n_workers; i++) {
+        RctGstExecutorWorker *worker = &rct_gst_executor.workers[i];
+        gchar *thread_name = g_strdup_printf("player_executor_%u", i);
+
+        worker->context = g_main_context_new();
+        worker->loop = g_main_loop_new(worker->context, FALSE);
+        worker->thread = g_thread_new(thread_name, rct_gst_executor_run_worker, worker);
+
+        g_free(thread_name);
+    }
+
+    g_mutex_unlock(&rct_gst_executor.lock);
+    return TRUE;
+}
+
+static RctGstExecutorWorker *rct_gst_executor_acquire_worker(void) {
+    RctGstExecutorWorker *worker = NULL;
+    guint index = 0;
+    guint i = 0;
+
+    g_mutex_lock(&rct_gst_executor.lock);
+
+    if (rct_gst_executor.workers == NULL) {
+        g_mutex_unlock(&rct_gst_executor.lock);
+        return NULL;
+    }
+
+    index = rct_gst_executor.next_worker;
+
+    // Ties go to the next worker in round robin order
+    if (rct_gst_executor.policy == RCT_GST_EXECUTOR_LEAST_LOADED) {
+        for (i = 0; i < rct_gst_executor.n_workers; i++) {
+            guint candidate = (rct_gst_executor.next_worker + i) % rct_gst_executor.n_workers;
+
+            if (rct_gst_executor.workers[candidate].n_players <
+                rct_gst_executor.workers[index].n_players)
+                index = candidate;
+        }
+    }
+
+    worker = &rct_gst_executor.workers[index];
+    worker->n_players++;
+    rct_gst_executor.next_worker = (index + 1) % rct_gst_executor.n_workers;
+
+    g_mutex_unlock(&rct_gst_executor.lock);
+    return worker;
+}
+
+static void rct_gst_executor_release_worker(RctGstExecutorWorker *worker) {
+    g_mutex_lock(&rct_gst_executor.lock);
+    worker->n_players--;
+    g_mutex_unlock(&rct_gst_executor.lock);
+}
+
+// Shared task pool
+// Scheduling latency is the wait of a task for its thread to start
+static void cb_run_task(gpointer data, gpointer user_data) {
+    (void) user_data;
+
+    RctGstTaskJob *job = (RctGstTaskJob *) data;
+    gint64 latency = g_get_monotonic_time() - job->push_time;
+
+    g_mutex_lock(&rct_gst_shared_task_pool.lock);
+    rct_gst_shared_task_pool.tasks++;
+    rct_gst_shared_task_pool.total_latency += latency;
+    rct_gst_shared_task_pool.max_latency = MAX(rct_gst_shared_task_pool.max_latency, latency);
+    rct_gst_shared_task_pool.peak_threads = MAX(rct_gst_shared_task_pool.peak_threads,
+                                         g_thread_pool_get_num_threads(rct_gst_shared_task_pool.threads));
+    g_mutex_unlock(&rct_gst_shared_task_pool.lock);
+
+    job->func(job->user_data);
+    g_free(job);
+
+    g_mutex_lock(&rct_gst_shared_task_pool.lock);
+    rct_gst_shared_task_pool.running--;
+    g_mutex_unlock(&rct_gst_shared_task_pool.lock);
+}
+
+static void rct_gst_task_pool_prepare(GstTaskPool *pool, GError **error) {
+    (void) pool;
+
+    if (rct_gst_shared_task_pool.threads == NULL)
+        rct_gst_shared_task_pool.threads = g_thread_pool_new(cb_run_task, NULL, rct_gst_shared_task_pool.max_threads,
+                                                      FALSE, error);
+}
+
+// Threads are shared by every player, they are never released
+static void rct_gst_task_pool_cleanup(GstTaskPool *pool) {
+    (void) pool;
+}
+
+static gpointer rct_gst_task_pool_push(GstTaskPool *pool,
+                                       GstTaskPoolFunction func,
+                                       gpointer user_data,
+                                       GError **error) {
+    (void) pool;
+
+    RctGstTaskJob *job = g_malloc0(sizeof(RctGstTaskJob));
+
+    job->func = func;
+    job->user_data = user_data;
+    job->push_time = g_get_monotonic_time();
+
+    g_mutex_lock(&rct_gst_shared_task_pool.lock);
+
+    // Streaming tasks only return once their element stops : a queued one could wait forever,
+    // and so would the join of its task
+    if (rct_gst_shared_task_pool.max_threads >= 0 &&
+        rct_gst_shared_task_pool.running >= (guint) g_thread_pool_get_max_threads(rct_gst_shared_task_pool.threads)) {
+        g_thread_pool_set_max_threads(rct_gst_shared_task_pool.threads,
+                                      (gint) rct_gst_shared_task_pool.running + 1, NULL);
+        rct_gst_shared_task_pool.overflow_tasks++;
+    }
+
+    rct_gst_shared_task_pool.running++;
+
+    g_mutex_unlock(&rct_gst_shared_task_pool.lock);
+
+    // Still queued when no thread could be created, its function then exits with its stopped task
+    g_thread_pool_push(rct_gst_shared_task_pool.threads, job, error);
+
+    return NULL;
+}
+
+// Tasks wait for their own end, there is nothing to join
+static void rct_gst_task_pool_join(GstTaskPool *pool, gpointer id) {
+    (void) pool;
+    (void) id;
+}
+
+static void rct_gst_task_pool_class_init(RctGstTaskPoolClass *klass) {
+    GstTaskPoolClass *task_pool_class = GST_TASK_POOL_CLASS(klass);
+
+    task_pool_class->prepare = rct_gst_task_pool_prepare;
+    task_pool_class->cleanup = rct_gst_task_pool_cleanup;
+    task_pool_class->push = rct_gst_task_pool_push;
+    task_pool_class->join = rct_gst_task_pool_join;
+}
+
+static void rct_gst_task_pool_init(RctGstTaskPool *self) {
+    (void) self;
+}
+
+gboolean rct_gst_player_task_pool_init(gint max_threads) {
+    GError *error = NULL;
+    guint i = 0;
+
+    g_mutex_lock(&rct_gst_shared_task_pool.lock);
+
+    if (rct_gst_shared_task_pool.pool != NULL) {
+        g_mutex_unlock(&rct_gst_shared_task_pool.lock);
+        return FALSE;
+    }
+
+    rct_gst_shared_task_pool.max_threads = max_threads;
+
+#ifdef __linux__
+    // From the calling thread, as every thread created afterwards
+    rct_gst_shared_task_pool.default_nice = getpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid));
+    sched_getaffinity(0, sizeof(cpu_set_t), &rct_gst_shared_task_pool.default_affinity);
+#endif
+
+    for (i = 0; i < RCT_GST_N_TASK_ROLES; i++) {
+        rct_gst_shared_task_pool.scheduling[i].nice = rct_gst_shared_task_pool.default_nice;
+        rct_gst_shared_task_pool.scheduling[i].cpu_mask = 0;
+    }
+
+    rct_gst_shared_task_pool.pool = g_object_new(rct_gst_task_pool_get_type(), NULL);
+    gst_object_ref_sink(rct_gst_shared_task_pool.pool);
+    gst_task_pool_prepare(rct_gst_shared_task_pool.pool, &error);
+
+    if (error) {
+        g_printerr("Unable to prepare the task pool : %s\n", error->message);
+        g_error_free(error);
+        gst_object_unref(rct_gst_shared_task_pool.pool);
+        rct_gst_shared_task_pool.pool = NULL;
+    }
+
+    g_mutex_unlock(&rct_gst_shared_task_pool.lock);
+    return rct_gst_shared_task_pool.pool != NULL;
+}
+
+void rct_gst_player_set_task_scheduling(RctGstTaskRole role, gint nice, guint64 cpu_mask) {
+    g_mutex_lock(&rct_gst_shared_task_pool.lock);
+    rct_gst_shared_task_pool.scheduling[role].nice = nice;
+    rct_gst_shared_task_pool.scheduling[role].cpu_mask = cpu_mask;
+    g_mutex_unlock(&rct_gst_shared_task_pool.lock);
+}
+
+void rct_gst_player_get_task_pool_stats(RctGstTaskPoolStats *stats) {
+    memset(stats, 0, sizeof(RctGstTaskPoolStats));
+
+    g_mutex_lock(&rct_gst_shared_task_pool.lock);
+
+    if (rct_gst_shared_task_pool.threads) {
+        stats->threads = g_thread_pool_get_num_threads(rct_gst_shared_task_pool.threads);
+        stats->queued_tasks = g_thread_pool_unprocessed(rct_gst_shared_task_pool.threads);
+    }
+
+    stats->max_threads = rct_gst_shared_task_pool.max_threads;
+    stats->peak_threads = rct_gst_shared_task_pool.peak_threads;
+    stats->tasks = rct_gst_shared_task_pool.tasks;
+    stats->overflow_tasks = rct_gst_shared_task_pool.overflow_tasks;
+    stats->max_scheduling_latency = rct_gst_shared_task_pool.max_latency;
+    if (rct_gst_shared_task_pool.tasks > 0)
+        stats->mean_scheduling_latency = rct_gst_shared_task_pool.total_latency / (gint64) rct_gst_shared_task_pool.tasks;
+
+    g_mutex_unlock(&rct_gst_shared_task_pool.lock);
+}
+
+static RctGstTaskRole rct_gst_task_role_of_element(GstElement *element) {
+    const gchar *klass = NULL;
+
+    klass = gst_element_class_get_metadata(GST_ELEMENT_GET_CLASS(element), GST_ELEMENT_METADATA_KLASS);
+    if (klass == NULL)
+        return RCT_GST_TASK_ROLE_OTHER;
+
+    if (strstr(klass, "Sink") && strstr(klass, "Audio"))
+        return RCT_GST_TASK_ROLE_AUDIO_SINK;
+    if (strstr(klass, "Sink") && strstr(klass, "Video"))
+        return RCT_GST_TASK_ROLE_VIDEO_SINK;
+    if (strstr(klass, "Demux") || strstr(klass, "Decoder") || strstr(klass, "Parser"))
+        return RCT_GST_TASK_ROLE_DEMUX_DECODE;
+
+    return RCT_GST_TASK_ROLE_OTHER;
+}
+
+// Sinks rarely own a task : the thread of the queue right before one takes the sink role
+static RctGstTaskRole rct_gst_task_role(GstElement *owner) {
+    RctGstTaskRole role = rct_gst_task_role_of_element(owner);
+    GstPad *pad = NULL;
+    GstPad *peer = NULL;
+    GstElement *downstream = NULL;
+
+    if (role != RCT_GST_TASK_ROLE_OTHER)
+        return role;
+
+    pad = gst_element_get_static_pad(owner, "src");
+    if (pad)
+        peer = gst_pad_get_peer(pad);
+    if (peer)
+        downstream = gst_pad_get_parent_element(peer);
+
+    if (downstream) {
+        RctGstTaskRole downstream_role = rct_gst_task_role_of_element(downstream);
+
+        if (downstream_role == RCT_GST_TASK_ROLE_AUDIO_SINK || downstream_role == RCT_GST_TASK_ROLE_VIDEO_SINK)
+            role = downstream_role;
+        gst_object_unref(downstream);
+    }
+
+    if (peer)
+        gst_object_unref(peer);
+    if (pad)
+        gst_object_unref(pad);
+
+    return role;
+}
+
+// Applied to the calling thread, Linux and Android only
+static void rct_gst_task_pool_schedule_thread(gint nice, guint64 cpu_mask, gboolean restore) {
+#ifdef __linux__
+    cpu_set_t affinity;
+    guint cpu = 0;
+
+    setpriority(PRIO_PROCESS, (id_t) syscall(SYS_gettid), nice);
+
+    if (restore) {
+        sched_setaffinity(0, sizeof(cpu_set_t), &rct_gst_shared_task_pool.default_affinity);
+    } else if (cpu_mask) {
+        CPU_ZERO(&affinity);
+        for (cpu = 0; cpu < 64; cpu++) {
+            if (cpu_mask & (G_GUINT64_CONSTANT(1) << cpu))
+                CPU_SET(cpu, &affinity);
+        }
+        sched_setaffinity(0, sizeof(cpu_set_t), &affinity);
+    }
+#else
+    (void) nice;
+    (void) cpu_mask;
+    (void) restore;
+#endif
+}
+
+// Stream status messages are posted by the thread creating the task, then by the task thread itself
+static void rct_gst_task_pool_handle_stream_status(GstMessage *message) {
+    GstStreamStatusType type = GST_STREAM_STATUS_TYPE_CREATE;
+    GstElement *owner = NULL;
+    const GValue *object = NULL;
+    RctGstTaskScheduling scheduling;
+
+    gst_message_parse_stream_status(message, &type, &owner);
+
+    switch (type) {
+        case GST_STREAM_STATUS_TYPE_CREATE:
+            object = gst_message_get_stream_status_object(message);
+            if (object && G_VALUE_HOLDS_OBJECT(object) && GST_IS_TASK(g_value_get_object(object)))
+                gst_task_set_pool(GST_TASK(g_value_get_object(object)), rct_gst_shared_task_pool.pool);
+            break;
+
+        case GST_STREAM_STATUS_TYPE_ENTER:
+            g_mutex_lock(&rct_gst_shared_task_pool.lock);
+            scheduling = rct_gst_shared_task_pool.scheduling[rct_gst_task_role(owner)];
+            g_mutex_unlock(&rct_gst_shared_task_pool.lock);
+
+            rct_gst_task_pool_schedule_thread(scheduling.nice, scheduling.cpu_mask, FALSE);
+            break;
+
+        case GST_STREAM_STATUS_TYPE_LEAVE:
+            rct_gst_task_pool_schedule_thread(rct_gst_shared_task_pool.default_nice, 0, TRUE);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Runs on the posting thread, before the bus watch
+// Bus sync handler
+static GstBusSyncReply cb_bus_sync(GstBus *bus, GstMessage *message, gpointer user_data) {
+    (void) bus;
+
+    if (GST_MESSAGE_TYPE(message) == GST_MESSAGE_STREAM_STATUS && rct_gst_shared_task_pool.pool)
+        rct_gst_task_pool_handle_stream_status(message);
+
+    return rct_gst_bus_handler_receive((RctGstBusHandler *) user_data, message);
+}
+
+static void rct_gst_bus_handler_free(gpointer data) {
+    RctGstBusHandler *handler = (RctGstBusHandler *) data;
+
+    g_mutex_clear(&handler->lock);
+    g_free(handler);
+}
+
+// Called on every pipeline built by the player, before its tasks get created
+// Installed once for the lifetime of the pipeline, a bus only takes one sync handler
+static RctGstBusHandler *rct_gst_player_handle_bus(GstPipeline *pipeline) {
+    GstBus *bus = NULL;
+    RctGstBusHandler *handler = NULL;
+
+    if (pipeline == NULL)
+        return NULL;
+
+    bus = gst_pipeline_get_bus(pipeline);
+
+    handler = g_object_get_data(G_OBJECT(bus), RCT_GST_BUS_HANDLER_KEY);
+    if (handler == NULL) {
+        handler = g_malloc0(sizeof(RctGstBusHandler));
+        g_mutex_init(&handler->lock);
+        handler->pipeline = pipeline;
+
+        g_object_set_data(G_OBJECT(bus), RCT_GST_BUS_HANDLER_KEY, handler);
+        gst_bus_set_sync_handler(bus, cb_bus_sync, handler, rct_gst_bus_handler_free);
+    }
+
+    gst_object_unref(bus);
+
+    return handler;
+}
+
+// Threading operations
+static gboolean cb_notify_player_loaded(gpointer data) {
+    RctGstPlayer *self;
+
+    self = (RctGstPlayer *) data;
+
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PLAYER_LOADED, NULL, 0, NULL);
+
+    if (self->on_rct_gst_player_loaded) {
+        gint64 start_time = g_get_monotonic_time();
+
+        self->on_rct_gst_player_loaded(self);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_PLAYER_LOADED, start_time);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+static gpointer rct_gst_player_run_thread(gpointer data) {
+    RctGstPlayer *self;
+
+    self = (RctGstPlayer *) data;
+    g_main_context_push_thread_default(self->context);
+
+    g_print("%s : Player loop is starting...\n", self->debug_tag);
+
+    if (self->on_rct_gst_player_loaded) {
+        gint64 start_time = g_get_monotonic_time();
+
+        self->on_rct_gst_player_loaded(self);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_PLAYER_LOADED, start_time);
+    }
+
+    g_main_loop_run(self->loop);
+    g_print("%s : Player loop is stopping...\n", self->debug_tag);
+
+    // Posted after the stop, their drain would never be dispatched
+    rct_gst_player_discard_commands(self);
+    rct_gst_player_flush_snapshots(self);
+
+    g_main_context_pop_thread_default(self->context);
+    g_object_unref(self);
+
+    return NULL;
+}
+
+// Thread public starting point
+void rct_gst_player_start(RctGstPlayer *self) {
+    g_atomic_int_set(&self->stopped, FALSE);
+
+    if (self->use_shared_executor)
+        self->executor_worker = rct_gst_executor_acquire_worker();
+
+    // Snapshot workers look at the context
+    g_mutex_lock(&self->stats_lock);
+
+    if (self->executor_worker) {
+        self->context = g_main_context_ref(((RctGstExecutorWorker *) self->executor_worker)->context);
+    } else {
+        self->context = g_main_context_new();
+        self->loop = g_main_loop_new(self->context, FALSE);
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+
+    // A pipeline set before starting is watched from the default context until now
+    if (self->bus_watch)
+        rct_gst_player_rewatch_bus(self);
+
+    self->start_time = g_get_monotonic_time();
+    rct_gst_player_schedule_stats(self);
+    rct_gst_player_schedule_memory_budget(self);
+
+    if (self->executor_worker)
+        g_main_context_invoke_full(self->context,
+                                   G_PRIORITY_DEFAULT,
+                                   cb_notify_player_loaded,
+                                   g_object_ref(self),
+                                   g_object_unref);
+    else
+        self->thread = g_thread_new("player_thread", rct_gst_player_run_thread, g_object_ref(self));
+}
+
+// Pending commands are applied before the player actually stops
+void rct_gst_player_stop(RctGstPlayer *self) {
+    RctGstCommand *command = NULL;
+
+    command = g_malloc0(sizeof(RctGstCommand));
+    command->type = RCT_GST_COMMAND_STOP;
+
+    rct_gst_player_post_command(self, command);
+}
+
+static void rct_gst_player_apply_stop(RctGstPlayer *self) {
+    g_atomic_int_set(&self->stopped, TRUE);
+
+    // Startup probes hold the player
+    rct_gst_player_clear_startup_probes(self);
+    rct_gst_player_flush_property_writes(self);
+    rct_gst_player_clear_source(&self->stats_source);
+    rct_gst_player_clear_source(&self->position_source);
+    rct_gst_player_clear_source(&self->budget_source);
+
+    if (self->loop) {
+        g_main_loop_quit(self->loop);
+        return;
+    }
+
+    // The shared worker keeps running for the other players
+    rct_gst_player_unwatch_bus(self);
+
+    if (self->executor_worker) {
+        rct_gst_executor_release_worker(self->executor_worker);
+        self->executor_worker = NULL;
+    }
+}
+
+// Setters
+static void rct_gst_player_set_debug_tag(RctGstPlayer *self, gchar *parse_launch_pipeline) {
+    self->debug_tag = parse_launch_pipeline;
+    g_print("%s : Setting property debug_tag: %s\n", self->debug_tag, self->debug_tag);
+}
+
+static void rct_gst_player_set_drawable_surface(RctGstPlayer *self, gpointer drawable_surface) {
+    GstElement *video_sink = NULL;
+    GstVideoOverlay *video_overlay = NULL;
+
+    g_atomic_pointer_set(&self->drawable_surface, drawable_surface);
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_DRAWABLE_SURFACE, NULL,
+                  (gintptr) self->drawable_surface, NULL);
+
+    if (self->pipeline == NULL)
+        return;
+
+    video_sink = gst_bin_get_by_interface(GST_BIN(self->pipeline), GST_TYPE_VIDEO_OVERLAY);
+    video_overlay = GST_VIDEO_OVERLAY(video_sink);
+
+    if (video_overlay) {
+        gst_video_overlay_set_window_handle(video_overlay, (guintptr) self->drawable_surface);
+        gst_object_unref(video_sink);
+    }
+
+    // The next item of the playlist renders into the same surface
+    if (self->preloaded_pipeline == NULL)
+        return;
+
+    video_sink = gst_bin_get_by_interface(GST_BIN(self->preloaded_pipeline), GST_TYPE_VIDEO_OVERLAY);
+    video_overlay = GST_VIDEO_OVERLAY(video_sink);
+
+    if (video_overlay) {
+        gst_video_overlay_set_window_handle(video_overlay, (guintptr) self->drawable_surface);
+        gst_object_unref(video_sink);
+    }
+}
+
+static void rct_gst_player_set_desired_state(RctGstPlayer *self, GstState state) {
+    self->desired_state = state;
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_DESIRED_STATE, NULL, state, NULL);
+
+    if (self->pipeline == NULL)
+        return;
+
+    // Held paused until buffered, buffering resumes to the desired state
+    if (state == GST_STATE_PLAYING && self->buffering)
+        state = GST_STATE_PAUSED;
+
+    g_mutex_lock(&self->stats_lock);
+    self->state_change_target = state;
+    self->state_change_start = g_get_monotonic_time();
+    g_mutex_unlock(&self->stats_lock);
+
+    gst_element_set_state(GST_ELEMENT(self->pipeline), state);
+}
+
+// Pipeline teardown
+static gint64 rct_gst_player_teardown_pipeline(GstPipeline *pipeline) {
+    gint64 start_time = g_get_monotonic_time();
+
+    gst_element_set_state(GST_ELEMENT(pipeline), GST_STATE_NULL);
+    gst_object_unref(pipeline);
+
+    return g_get_monotonic_time() - start_time;
+}
+
+static void rct_gst_player_report_teardown(RctGstPlayer *self, gint64 teardown_duration) {
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PIPELINE_TEARDOWN, NULL,
+                  teardown_duration, NULL);
+
+    g_mutex_lock(&self->stats_lock);
+    self->last_teardown_duration = teardown_duration;
+    g_mutex_unlock(&self->stats_lock);
+
+    if (self->on_rct_gst_pipeline_teardown) {
+        gint64 start_time = g_get_monotonic_time();
+
+        self->on_rct_gst_pipeline_teardown(self, teardown_duration);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_PIPELINE_TEARDOWN, start_time);
+    }
+}
+
+static void cb_reap_pipeline(gpointer data, gpointer user_data) {
+    (void) user_data;
+
+    RctGstTeardownJob *job = NULL;
+
+    job = (RctGstTeardownJob *) data;
+    rct_gst_player_report_teardown(job->self, rct_gst_player_teardown_pipeline(job->pipeline));
+
+    g_object_unref(job->self);
+    g_free(job);
+}
+
+// Single thread shared by all players, NULL transitions can block for a long time
+static GThreadPool *rct_gst_player_get_reaper(void) {
+    static gsize reaper = 0;
+
+    if (g_once_init_enter(&reaper)) {
+        GThreadPool *pool = g_thread_pool_new(cb_reap_pipeline, NULL, 1, FALSE, NULL);
+        g_once_init_leave(&reaper, (gsize) pool);
+    }
+
+    return (GThreadPool *) reaper;
+}
+
+// Takes ownership of the pipeline and brings it down to NULL
+static void rct_gst_player_destroy_pipeline(RctGstPlayer *self, GstPipeline *pipeline) {
+    RctGstTeardownJob *job = NULL;
+
+    if (!self->async_teardown) {
+        rct_gst_player_report_teardown(self, rct_gst_player_teardown_pipeline(pipeline));
+        return;
+    }
+
+    job = g_malloc0(sizeof(RctGstTeardownJob));
+    job->self = g_object_ref(self);
+    job->pipeline = pipeline;
+
+    g_thread_pool_push(rct_gst_player_get_reaper(), job, NULL);
+}
+
+// Pipeline cache
+static void rct_gst_player_free_cached_pipeline(RctGstPlayer *self,
+                                                RctGstCachedPipeline *cached_pipeline) {
+    rct_gst_player_destroy_pipeline(self, cached_pipeline->pipeline);
+
+    g_free(cached_pipeline->parse_launch_pipeline);
+    g_free(cached_pipeline);
+}
+
+static GstPipeline *rct_gst_player_take_cached_pipeline(RctGstPlayer *self,
+                                                        const gchar *parse_launch_pipeline) {
+    GList *link = NULL;
+    RctGstCachedPipeline *cached_pipeline = NULL;
+    GstPipeline *pipeline = NULL;
+
+    if (self->pipeline_cache_size == 0)
+        return NULL;
+
+    g_mutex_lock(&self->stats_lock);
+
+    for (link = self->pipeline_cache->head; link != NULL; link = link->next) {
+        cached_pipeline = (RctGstCachedPipeline *) link->data;
+
+        // Tuned elements can't be brought back to their defaults, untuned ones get tuned once current
+        if (g_object_get_data(G_OBJECT(cached_pipeline->pipeline), RCT_GST_LOW_LATENCY_KEY) &&
+            !self->live_low_latency)
+            continue;
+
+        if (g_strcmp0(cached_pipeline->parse_launch_pipeline, parse_launch_pipeline) == 0)
+            break;
+    }
+
+    if (link == NULL) {
+        self->pipeline_cache_misses++;
+        g_mutex_unlock(&self->stats_lock);
+        return NULL;
+    }
+
+    self->pipeline_cache_hits++;
+    g_queue_delete_link(self->pipeline_cache, link);
+
+    g_mutex_unlock(&self->stats_lock);
+
+    pipeline = cached_pipeline->pipeline;
+
+    g_free(cached_pipeline->parse_launch_pipeline);
+    g_free(cached_pipeline);
+
+    return pipeline;
+}
+
+// Pipelines are destroyed outside of stats_lock, their teardown reports under it
+static void rct_gst_player_trim_pipeline_cache(RctGstPlayer *self) {
+    RctGstCachedPipeline *cached_pipeline = NULL;
+
+    do {
+        g_mutex_lock(&self->stats_lock);
+        cached_pipeline = g_queue_get_length(self->pipeline_cache) > self->pipeline_cache_size ?
+                          g_queue_pop_tail(self->pipeline_cache) : NULL;
+        g_mutex_unlock(&self->stats_lock);
+
+        if (cached_pipeline)
+            rct_gst_player_free_cached_pipeline(self, cached_pipeline);
+    } while (cached_pipeline != NULL);
+}
+
+// Takes ownership of the pipeline : either keeps it warm in the cache or destroys it
+static void rct_gst_player_release_pipeline(RctGstPlayer *self,
+                                            const gchar *parse_launch_pipeline,
+                                            GstPipeline *pipeline) {
+    RctGstCachedPipeline *cached_pipeline = NULL;
+
+    if (self->pipeline_cache_size == 0 || parse_launch_pipeline == NULL) {
+        rct_gst_player_destroy_pipeline(self, pipeline);
+        return;
+    }
+
+    // Nobody is listening to a cached pipeline, its messages would only pile up
+    rct_gst_player_detach_bus(pipeline);
+
+    gst_element_set_state(GST_ELEMENT(pipeline), self->pipeline_cache_state);
+
+    cached_pipeline = g_malloc0(sizeof(RctGstCachedPipeline));
+    cached_pipeline->parse_launch_pipeline = g_strdup(parse_launch_pipeline);
+    cached_pipeline->pipeline = pipeline;
+
+    g_mutex_lock(&self->stats_lock);
+    g_queue_push_head(self->pipeline_cache, cached_pipeline);
+    g_mutex_unlock(&self->stats_lock);
+
+    rct_gst_player_trim_pipeline_cache(self);
+}
+
+static void rct_gst_player_set_pipeline_cache_size(RctGstPlayer *self, guint pipeline_cache_size) {
+    self->pipeline_cache_size = pipeline_cache_size;
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PROPERTY, "pipeline_cache_size",
+                  self->pipeline_cache_size, NULL);
+
+    rct_gst_player_trim_pipeline_cache(self);
+}
+
+void rct_gst_player_clear_pipeline_cache(RctGstPlayer *self) {
+    RctGstCachedPipeline *cached_pipeline = NULL;
+
+    do {
+        g_mutex_lock(&self->stats_lock);
+        cached_pipeline = g_queue_pop_head(self->pipeline_cache);
+        g_mutex_unlock(&self->stats_lock);
+
+        if (cached_pipeline)
+            rct_gst_player_free_cached_pipeline(self, cached_pipeline);
+    } while (cached_pipeline != NULL);
+}
+
+void rct_gst_player_get_pipeline_cache_stats(RctGstPlayer *self,
+                                             guint64 *hits,
+                                             guint64 *misses,
+                                             guint *cached_pipelines) {
+    g_mutex_lock(&self->stats_lock);
+
+    if (hits)
+        *hits = self->pipeline_cache_hits;
+
+    if (misses)
+        *misses = self->pipeline_cache_misses;
+
+    if (cached_pipelines)
+        *cached_pipelines = g_queue_get_length(self->pipeline_cache);
+
+    g_mutex_unlock(&self->stats_lock);
+}
+
+// Element and property resolution
+static void rct_gst_property_target_free(RctGstPropertyTarget *target) {
+    if (G_IS_VALUE(&target->value))
+        g_value_unset(&target->value);
+
+    if (G_IS_VALUE(&target->pending_value))
+        g_value_unset(&target->pending_value);
+
+    g_free(target);
+}
+
+static void rct_gst_element_target_free(RctGstElementTarget *target) {
+    g_hash_table_unref(target->properties);
+    gst_object_unref(target->element);
+    g_free(target);
+}
+
+static RctGstElementTarget *rct_gst_player_add_element_target(RctGstPlayer *self,
+                                                              GstElement *element) {
+    RctGstElementTarget *target = NULL;
+
+    target = g_malloc0(sizeof(RctGstElementTarget));
+    target->element = gst_object_ref(element);
+    target->properties = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                               (GDestroyNotify) rct_gst_property_target_free);
+
+    g_hash_table_insert(self->element_targets, g_strdup(GST_ELEMENT_NAME(element)), target);
+    return target;
+}
+
+static void cb_add_element_target(const GValue *item, gpointer user_data) {
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+    GstElement *element = GST_ELEMENT(g_value_get_object(item));
+
+    // Same lookup order as gst_bin_get_by_name : the first element found wins
+    if (!g_hash_table_contains(self->element_targets, GST_ELEMENT_NAME(element)))
+        rct_gst_player_add_element_target(self, element);
+}
+
+// Elements are resolved once per pipeline, their properties on first use.
+// Pending writes are dropped along with them : flush them first to keep them.
+static void rct_gst_player_reset_element_targets(RctGstPlayer *self) {
+    GstIterator *iterator = NULL;
+
+    rct_gst_player_clear_source(&self->property_batch_source);
+    g_ptr_array_set_size(self->pending_writes, 0);
+    g_hash_table_remove_all(self->element_targets);
+    g_atomic_int_set(&self->element_targets_stale, FALSE);
+
+    if (self->pipeline == NULL)
+        return;
+
+    iterator = gst_bin_iterate_recurse(GST_BIN(self->pipeline));
+    gst_iterator_foreach(iterator, cb_add_element_target, self);
+    gst_iterator_free(iterator);
+}
+
+static void rct_gst_player_report_property_error(RctGstPlayer *self, gchar *error_detail) {
+    if (self->on_rct_gst_pipeline_error) {
+        gint64 start_time = g_get_monotonic_time();
+
+        self->on_rct_gst_pipeline_error(self, "pipeline", error_detail, "");
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_ERROR, start_time);
+    }
+
+    g_free(error_detail);
+}
+
+static RctGstPropertyTarget *rct_gst_player_resolve_property(RctGstPlayer *self,
+                                                             const gchar *element_name,
+                                                             const gchar *property_name) {
+    RctGstElementTarget *element_target = NULL;
+    RctGstPropertyTarget *property_target = NULL;
+    GParamSpec *pspec = NULL;
+
+    // Segments swapped from a streaming thread leave the resolved elements out of date
+    if (g_atomic_int_get(&self->element_targets_stale)) {
+        rct_gst_player_flush_property_writes(self);
+        rct_gst_player_reset_element_targets(self);
+    }
+
+    element_target = g_hash_table_lookup(self->element_targets, element_name);
+    if (element_target) {
+        property_target = g_hash_table_lookup(element_target->properties, property_name);
+        if (property_target) {
+            g_mutex_lock(&self->stats_lock);
+            self->property_cache_hits++;
+            g_mutex_unlock(&self->stats_lock);
+            return property_target;
+        }
+    }
+
+    g_mutex_lock(&self->stats_lock);
+    self->property_cache_misses++;
+    g_mutex_unlock(&self->stats_lock);
+
+    // Elements created after the pipeline (decodebin children...) are resolved on demand
+    if (element_target == NULL) {
+        GstElement *element = NULL;
+
+        if (self->pipeline)
+            element = gst_bin_get_by_name(GST_BIN(self->pipeline), element_name);
+
+        if (element == NULL) {
+            rct_gst_player_report_property_error(
+                    self, g_strdup_printf("Element %s doesn't exists", element_name));
+            return NULL;
+        }
+
+        element_target = rct_gst_player_add_element_target(self, element);
+        gst_object_unref(element);
+    }
+
+    pspec = g_object_class_find_property(G_OBJECT_GET_CLASS(element_target->element),
+                                         property_name);
+    if (pspec == NULL || !(pspec->flags & G_PARAM_WRITABLE)) {
+        rct_gst_player_report_property_error(
+                self, g_strdup_printf("Property %s doesn't exists on element %s",
+                                      property_name, element_name));
+        return NULL;
+    }
+
+    property_target = g_malloc0(sizeof(RctGstPropertyTarget));
+    property_target->element = element_target->element;
+    property_target->pspec = pspec;
+
+    // Writes of the current value are elided as well
+    if (pspec->flags & G_PARAM_READABLE) {
+        g_value_init(&property_target->value, G_PARAM_SPEC_VALUE_TYPE(pspec));
+        g_object_get_property(G_OBJECT(element_target->element), pspec->name,
+                              &property_target->value);
+    }
+
+    g_hash_table_insert(element_target->properties, g_strdup(property_name), property_target);
+    return property_target;
+}
+
+// Converts value to the type of the property, target is left unset on failure
+static gboolean rct_gst_player_convert_value(const GValue *value,
+                                             GParamSpec *pspec,
+                                             GValue *target) {
+    GType value_type = G_VALUE_TYPE(value);
+    GType target_type = G_PARAM_SPEC_VALUE_TYPE(pspec);
+
+    g_value_init(target, target_type);
+
+    if (value_type == target_type) {
+        g_value_copy(value, target);
+        return TRUE;
+    }
+
+    if (G_TYPE_IS_ENUM(target_type) && value_type == G_TYPE_INT64) {
+        g_value_set_enum(target, (gint) g_value_get_int64(value));
+        return TRUE;
+    }
+
+    if (G_TYPE_IS_FLAGS(target_type) && value_type == G_TYPE_INT64) {
+        g_value_set_flags(target, (guint) g_value_get_int64(value));
+        return TRUE;
+    }
+
+    // Strings hold serialized values (caps, enum nicks, fractions...)
+    if (value_type == G_TYPE_STRING &&
+        gst_value_deserialize(target, g_value_get_string(value)))
+        return TRUE;
+
+    if (g_value_type_transformable(value_type, target_type) &&
+        g_value_transform(value, target))
+        return TRUE;
+
+    g_value_unset(target);
+    return FALSE;
+}
+
+// Property writes
+static void rct_gst_player_count_property_write(RctGstPlayer *self, gboolean applied) {
+    g_mutex_lock(&self->stats_lock);
+
+    if (applied)
+        self->property_writes_applied++;
+    else
+        self->property_writes_elided++;
+
+    g_mutex_unlock(&self->stats_lock);
+}
+
+static void rct_gst_player_apply_property(RctGstPlayer *self,
+                                          RctGstPropertyTarget *target,
+                                          const GValue *value) {
+    g_object_set_property(G_OBJECT(target->element), target->pspec->name, value);
+
+    if (G_IS_VALUE(&target->value))
+        g_value_unset(&target->value);
+
+    g_value_init(&target->value, G_VALUE_TYPE(value));
+    g_value_copy(value, &target->value);
+
+    rct_gst_player_count_property_write(self, TRUE);
+}
+
+static gboolean rct_gst_property_target_has_value(RctGstPropertyTarget *target,
+                                                  const GValue *value) {
+    return G_IS_VALUE(&target->value) &&
+           gst_value_compare(&target->value, value) == GST_VALUE_EQUAL;
+}
+
+static void rct_gst_player_flush_property_writes(RctGstPlayer *self) {
+    guint i = 0;
+
+    rct_gst_player_clear_source(&self->property_batch_source);
+
+    for (i = 0; i < self->pending_writes->len; i++) {
+        RctGstPropertyTarget *target = g_ptr_array_index(self->pending_writes, i);
+
+        // Back to the applied value since the last tick
+        if (rct_gst_property_target_has_value(target, &target->pending_value))
+            rct_gst_player_count_property_write(self, FALSE);
+        else
+            rct_gst_player_apply_property(self, target, &target->pending_value);
+
+        g_value_unset(&target->pending_value);
+        target->pending = FALSE;
+    }
+
+    g_ptr_array_set_size(self->pending_writes, 0);
+}
+
+static gboolean cb_flush_property_writes(gpointer user_data) {
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+
+    rct_gst_player_flush_property_writes(self);
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean rct_gst_player_get_video_framerate(RctGstPlayer *self, gint *fps_n, gint *fps_d) {
+    GstElement *video_sink = NULL;
+    GstPad *pad = NULL;
+    GstCaps *caps = NULL;
+    gboolean found = FALSE;
+
+    video_sink = gst_bin_get_by_interface(GST_BIN(self->pipeline), GST_TYPE_VIDEO_OVERLAY);
+    if (video_sink == NULL)
+        return FALSE;
+
+    pad = gst_element_get_static_pad(video_sink, "sink");
+    if (pad)
+        caps = gst_pad_get_current_caps(pad);
+
+    if (caps && gst_caps_get_size(caps) > 0)
+        found = gst_structure_get_fraction(gst_caps_get_structure(caps, 0), "framerate",
+                                           fps_n, fps_d) && *fps_n > 0 && *fps_d > 0;
+
+    if (caps)
+        gst_caps_unref(caps);
+    if (pad)
+        gst_object_unref(pad);
+    gst_object_unref(video_sink);
+
+    return found;
+}
+
+// In milliseconds, 0 when writes are applied right away
+static guint rct_gst_player_get_property_batch_interval(RctGstPlayer *self) {
+    gint fps_n = 0;
+    gint fps_d = 1;
+
+    // Writes have no thread to be batched on before the player starts
+    if (self->context == NULL)
+        return 0;
+
+    if (self->property_batch_frame_aligned && self->pipeline &&
+        rct_gst_player_get_video_framerate(self, &fps_n, &fps_d))
+        return MAX(1, (guint) gst_util_uint64_scale_int(1000, fps_d, fps_n));
+
+    return self->property_batch_interval;
+}
+
+// Writes of the value already written, or already pending, are elided
+static void rct_gst_player_write_property(RctGstPlayer *self,
+                                          RctGstPropertyTarget *target,
+                                          const GValue *value) {
+    gboolean queued = target->pending;
+    guint interval = 0;
+
+    if (target->pending) {
+        if (gst_value_compare(&target->pending_value, value) == GST_VALUE_EQUAL) {
+            rct_gst_player_count_property_write(self, FALSE);
+            return;
+        }
+
+        // Superseded before reaching the element
+        g_value_unset(&target->pending_value);
+        target->pending = FALSE;
+        rct_gst_player_count_property_write(self, FALSE);
+
+    } else if (rct_gst_property_target_has_value(target, value)) {
+        rct_gst_player_count_property_write(self, FALSE);
+        return;
+    }
+
+    // The interval is only looked up when a new batch starts
+    if (self->property_batch_source == NULL)
+        interval = rct_gst_player_get_property_batch_interval(self);
+
+    if (self->property_batch_source == NULL && interval == 0) {
+        rct_gst_player_flush_property_writes(self);
+
+        if (rct_gst_property_target_has_value(target, value))
+            rct_gst_player_count_property_write(self, FALSE);
+        else
+            rct_gst_player_apply_property(self, target, value);
+        return;
+    }
+
+    g_value_init(&target->pending_value, G_VALUE_TYPE(value));
+    g_value_copy(value, &target->pending_value);
+
+    // Superseded writes keep their place in the queue
+    if (!queued)
+        g_ptr_array_add(self->pending_writes, target);
+    target->pending = TRUE;
+
+    if (self->property_batch_source == NULL)
+        self->property_batch_source = rct_gst_player_attach_source(self,
+                                                                   g_timeout_source_new(interval),
+                                                                   cb_flush_property_writes,
+                                                                   self);
+}
+
+void rct_gst_player_get_property_write_stats(RctGstPlayer *self,
+                                             guint64 *applied,
+                                             guint64 *elided) {
+    g_mutex_lock(&self->stats_lock);
+
+    if (applied)
+        *applied = self->property_writes_applied;
+
+    if (elided)
+        *elided = self->property_writes_elided;
+
+    g_mutex_unlock(&self->stats_lock);
+}
+
+void rct_gst_player_get_property_cache_stats(RctGstPlayer *self,
+                                             guint64 *hits,
+                                             guint64 *misses) {
+    g_mutex_lock(&self->stats_lock);
+
+    if (hits)
+        *hits = self->property_cache_hits;
+
+    if (misses)
+        *misses = self->property_cache_misses;
+
+    g_mutex_unlock(&self->stats_lock);
+}
+
+// Frame taps
+static RctGstFrameTap *rct_gst_frame_tap_ref(RctGstFrameTap *tap) {
+    g_atomic_int_inc(&tap->ref_count);
+    return tap;
+}
+
+static void rct_gst_frame_tap_unref(RctGstFrameTap *tap) {
+    if (!g_atomic_int_dec_and_test(&tap->ref_count))
+        return;
+
+    if (tap->appsink)
+        gst_object_unref(tap->appsink);
+
+    g_mutex_clear(&tap->lock);
+    g_free(tap->element_name);
+    g_free(tap);
+}
+
+// Stops the callbacks for good, the branch being left in its pipeline. Returns the appsink it fed.
+static GstElement *rct_gst_frame_tap_disarm(RctGstFrameTap *tap, gboolean removed) {
+    GstElement *appsink = NULL;
+
+    g_mutex_lock(&tap->lock);
+
+    tap->removed = tap->removed || removed;
+    appsink = tap->appsink;
+    tap->appsink = NULL;
+
+    g_mutex_unlock(&tap->lock);
+
+    return appsink;
+}
+
+void rct_gst_frame_tap_release(GstVideoFrame *video_frame) {
+    RctGstTapFrame *frame = (RctGstTapFrame *) video_frame;
+
+    gst_video_frame_unmap(&frame->video_frame);
+    gst_sample_unref(frame->sample);
+
+    g_atomic_int_add(&frame->tap->in_flight, -1);
+    rct_gst_frame_tap_unref(frame->tap);
+    g_free(frame);
+}
+
+// Streaming thread of the branch : the frame is dropped whenever the consumer can't take it now
+static GstFlowReturn cb_tap_new_sample(GstAppSink *appsink, gpointer user_data) {
+    RctGstFrameTap *tap = (RctGstFrameTap *) user_data;
+    RctGstTapFrame *frame = NULL;
+    GstSample *sample = NULL;
+    GstVideoInfo video_info;
+    gint64 now = 0;
+    gint64 start_time = 0;
+
+    sample = gst_app_sink_pull_sample(appsink);
+    if (sample == NULL)
+        return GST_FLOW_OK;
+
+    // Held while delivering, so that no callback happens once the tap has been removed
+    g_mutex_lock(&tap->lock);
+
+    if (tap->removed || tap->appsink != GST_ELEMENT(appsink)) {
+        g_mutex_unlock(&tap->lock);
+        gst_sample_unref(sample);
+        return GST_FLOW_OK;
+    }
+
+    now = g_get_monotonic_time();
+
+    if ((tap->delivered > 0 && now - tap->last_delivery < tap->min_interval) ||
+        g_atomic_int_get(&tap->in_flight) >= tap->max_in_flight) {
+        tap->dropped++;
+        g_mutex_unlock(&tap->lock);
+        gst_sample_unref(sample);
+        return GST_FLOW_OK;
+    }
+
+    // Mapped in place, in whatever raw format has been negotiated
+    frame = g_malloc0(sizeof(RctGstTapFrame));
+    if (!gst_video_info_from_caps(&video_info, gst_sample_get_caps(sample)) ||
+        !gst_video_frame_map(&frame->video_frame, &video_info, gst_sample_get_buffer(sample),
+                             GST_MAP_READ)) {
+        tap->dropped++;
+        g_mutex_unlock(&tap->lock);
+        gst_sample_unref(sample);
+        g_free(frame);
+        return GST_FLOW_OK;
+    }
+
+    frame->sample = sample;
+    frame->tap = rct_gst_frame_tap_ref(tap);
+
+    tap->last_delivery = now;
+    tap->delivered++;
+    g_atomic_int_inc(&tap->in_flight);
+
+    start_time = g_get_monotonic_time();
+    tap->callback(tap->self, tap->id, &frame->video_frame, tap->user_data);
+    rct_gst_player_account_callback(tap->self, RCT_GST_CALLBACK_FRAME_TAP, start_time);
+
+    g_mutex_unlock(&tap->lock);
+
+    return GST_FLOW_OK;
+}
+
+// Answered here : with GstVideoMeta supported, the display path keeps its strided buffers as they are
+static GstPadProbeReturn cb_tap_allocation_query(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void) pad;
+    (void) user_data;
+
+    GstQuery *query = GST_PAD_PROBE_INFO_QUERY(info);
+
+    if (GST_QUERY_TYPE(query) != GST_QUERY_ALLOCATION)
+        return GST_PAD_PROBE_OK;
+
+    gst_query_add_allocation_meta(query, GST_VIDEO_META_API_TYPE, NULL);
+    return GST_PAD_PROBE_HANDLED;
+}
+
+static void rct_gst_frame_tap_arm(RctGstFrameTap *tap, GstElement *appsink) {
+    GstAppSinkCallbacks callbacks;
+
+    memset(&callbacks, 0, sizeof(callbacks));
+    callbacks.new_sample = cb_tap_new_sample;
+
+    gst_app_sink_set_callbacks(GST_APP_SINK(appsink), &callbacks, rct_gst_frame_tap_ref(tap),
+                               (GDestroyNotify) rct_gst_frame_tap_unref);
+
+    g_mutex_lock(&tap->lock);
+
+    if (tap->appsink)
+        gst_object_unref(tap->appsink);
+
+    tap->appsink = gst_object_ref(appsink);
+
+    g_mutex_unlock(&tap->lock);
+}
+
+static void rct_gst_tap_branch_free(RctGstTapBranch *branch) {
+    if (branch->tap)
+        rct_gst_frame_tap_unref(branch->tap);
+
+    g_object_unref(branch->self);
+    gst_object_unref(branch->pipeline);
+    gst_object_unref(branch->tee);
+    gst_object_unref(branch->queue);
+    gst_object_unref(branch->appsink);
+    g_free(branch);
+}
+
+static RctGstTapBranch *rct_gst_tap_branch_new(RctGstPlayer *self,
+                                               RctGstFrameTap *tap,
+                                               GstElement *tee,
+                                               GstElement *queue,
+                                               GstElement *appsink) {
+    RctGstTapBranch *branch = NULL;
+
+    branch = g_malloc0(sizeof(RctGstTapBranch));
+    branch->self = g_object_ref(self);
+    branch->tap = tap ? rct_gst_frame_tap_ref(tap) : NULL;
+    branch->pipeline = gst_object_ref(self->pipeline);
+    branch->tee = gst_object_ref(tee);
+    branch->queue = gst_object_ref(queue);
+    branch->appsink = gst_object_ref(appsink);
+
+    return branch;
+}
+
+// Tapped src pad -> tee -> former peer, and tee -> queue -> appsink
+static GstPadProbeReturn cb_insert_tap_branch(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void) info;
+
+    RctGstTapBranch *branch = (RctGstTapBranch *) user_data;
+    GstPad *peer = NULL;
+    GstPad *tee_pad = NULL;
+
+    // Held until inserted, so that a removal either finds the branch in place or prevents it
+    g_mutex_lock(&branch->tap->lock);
+
+    if (branch->tap->removed) {
+        g_mutex_unlock(&branch->tap->lock);
+        return GST_PAD_PROBE_REMOVE;
+    }
+
+    peer = gst_pad_get_peer(pad);
+    if (peer)
+        gst_pad_unlink(pad, peer);
+
+    gst_bin_add_many(GST_BIN(branch->pipeline), branch->tee, branch->queue, branch->appsink, NULL);
+
+    tee_pad = gst_element_get_static_pad(branch->tee, "sink");
+    if (gst_pad_link(pad, tee_pad) != GST_PAD_LINK_OK)
+        RCT_GST_TRACE(branch->self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_LINK_FAILED,
+                      GST_PAD_NAME(pad), 0, GST_ELEMENT_NAME(branch->tee));
+    gst_object_unref(tee_pad);
+
+    // The display path gets the first pad of the tee
+    if (peer) {
+        tee_pad = gst_element_get_request_pad(branch->tee, "src_%u");
+        if (gst_pad_link(tee_pad, peer) != GST_PAD_LINK_OK)
+            RCT_GST_TRACE(branch->self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_LINK_FAILED,
+                          GST_ELEMENT_NAME(branch->tee), 0, GST_PAD_NAME(peer));
+
+        gst_object_unref(tee_pad);
+        gst_object_unref(peer);
+    }
+
+    if (!gst_element_link_many(branch->tee, branch->queue, branch->appsink, NULL))
+        RCT_GST_TRACE(branch->self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_LINK_FAILED,
+                      GST_ELEMENT_NAME(branch->tee), 0, GST_ELEMENT_NAME(branch->appsink));
+
+    gst_element_sync_state_with_parent(branch->appsink);
+    gst_element_sync_state_with_parent(branch->queue);
+    gst_element_sync_state_with_parent(branch->tee);
+
+    g_mutex_unlock(&branch->tap->lock);
+
+    RCT_GST_TRACE(branch->self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_FRAME_TAP_ATTACHED,
+                  GST_ELEMENT_NAME(branch->tee), 0, GST_PAD_NAME(pad));
+
+    return GST_PAD_PROBE_REMOVE;
+}
+
+// Tapped src pad -> former peer, the branch being thrown away
+static GstPadProbeReturn cb_remove_tap_branch(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void) info;
+
+    RctGstTapBranch *branch = (RctGstTapBranch *) user_data;
+    GstPad *tee_pad = NULL;
+    GstPad *peer = NULL;
+    GList *link = NULL;
+
+    GST_OBJECT_LOCK(branch->tee);
+
+    for (link = GST_ELEMENT(branch->tee)->srcpads; link != NULL && peer == NULL; link = link->next) {
+        peer = gst_pad_get_peer(GST_PAD(link->data));
+
+        if (peer && GST_OBJECT_PARENT(peer) == GST_OBJECT(branch->queue)) {
+            gst_object_unref(peer);
+            peer = NULL;
+        }
+    }
+
+    GST_OBJECT_UNLOCK(branch->tee);
+
+    tee_pad = gst_element_get_static_pad(branch->tee, "sink");
+    gst_pad_unlink(pad, tee_pad);
+    gst_object_unref(tee_pad);
+
+    gst_element_set_state(branch->appsink, GST_STATE_NULL);
+    gst_element_set_state(branch->queue, GST_STATE_NULL);
+    gst_element_set_state(branch->tee, GST_STATE_NULL);
+    gst_bin_remove_many(GST_BIN(branch->pipeline), branch->tee, branch->queue, branch->appsink, NULL);
+
+    if (peer) {
+        if (gst_pad_link(pad, peer) != GST_PAD_LINK_OK)
+            RCT_GST_TRACE(branch->self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_LINK_FAILED,
+                          GST_PAD_NAME(pad), 0, GST_PAD_NAME(peer));
+
+        gst_object_unref(peer);
+    }
+
+    RCT_GST_TRACE(branch->self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_FRAME_TAP_REMOVED,
+                  GST_ELEMENT_NAME(branch->tee), 0, GST_PAD_NAME(pad));
+
+    return GST_PAD_PROBE_REMOVE;
+}
+
+static gchar *rct_gst_tap_get_element_name(guint tap_id, const gchar *role) {
+    return g_strdup_printf("rct_gst_tap_%u_%s", tap_id, role);
+}
+
+// Branches stay in their pipeline when it gets cached : they are only armed again
+static void rct_gst_player_attach_frame_tap(RctGstPlayer *self, RctGstFrameTap *tap) {
+    GstElement *element = NULL;
+    GstElement *tee = NULL;
+    GstElement *queue = NULL;
+    GstElement *appsink = NULL;
+    GstPad *src_pad = NULL;
+    GstPad *sink_pad = NULL;
+    gchar *tee_name = rct_gst_tap_get_element_name(tap->id, "tee");
+    gchar *queue_name = rct_gst_tap_get_element_name(tap->id, "queue");
+    gchar *appsink_name = rct_gst_tap_get_element_name(tap->id, "appsink");
+
+    if (self->pipeline == NULL)
+        goto out;
+
+    appsink = gst_bin_get_by_name(GST_BIN(self->pipeline), appsink_name);
+    if (appsink) {
+        rct_gst_frame_tap_arm(tap, appsink);
+        goto out;
+    }
+
+    element = gst_bin_get_by_name(GST_BIN(self->pipeline), tap->element_name);
+    if (element)
+        src_pad = gst_element_get_static_pad(element, "src");
+
+    if (src_pad == NULL) {
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_FRAME_TAP_FAILED,
+                      tap->element_name, tap->id, element ? "no src pad" : "no such element");
+        goto out;
+    }
+
+    tee = gst_object_ref_sink(gst_element_factory_make("tee", tee_name));
+    queue = gst_object_ref_sink(gst_element_factory_make("queue", queue_name));
+    appsink = gst_object_ref_sink(gst_element_factory_make("appsink", appsink_name));
+
+    // Only the latest frame waits for the consumer, older ones are dropped
+    g_object_set(queue, "leaky", 2 /* downstream */, "max-size-buffers", 1, "max-size-bytes", 0,
+                 "max-size-time", (guint64) 0, NULL);
+    g_object_set(appsink, "sync", FALSE, "async", FALSE, "max-buffers", 1, "drop", TRUE,
+                 "enable-last-sample", FALSE, NULL);
+
+    sink_pad = gst_element_get_static_pad(appsink, "sink");
+    gst_pad_add_probe(sink_pad, GST_PAD_PROBE_TYPE_QUERY_DOWNSTREAM, cb_tap_allocation_query, NULL, NULL);
+    gst_object_unref(sink_pad);
+
+    rct_gst_frame_tap_arm(tap, appsink);
+
+    gst_pad_add_probe(src_pad, GST_PAD_PROBE_TYPE_IDLE, cb_insert_tap_branch,
+                      rct_gst_tap_branch_new(self, tap, tee, queue, appsink),
+                      (GDestroyNotify) rct_gst_tap_branch_free);
+
+    out:
+    if (element)
+        gst_object_unref(element);
+
+    if (src_pad)
+        gst_object_unref(src_pad);
+
+    if (tee)
+        gst_object_unref(tee);
+
+    if (queue)
+        gst_object_unref(queue);
+
+    if (appsink)
+        gst_object_unref(appsink);
+
+    g_free(tee_name);
+    g_free(queue_name);
+    g_free(appsink_name);
+}
+
+// Branch of the current pipeline, taken out from an idle probe of the tapped pad
+static void rct_gst_player_remove_tap_branch(RctGstPlayer *self, guint tap_id) {
+    GstElement *tee = NULL;
+    GstElement *queue = NULL;
+    GstElement *appsink = NULL;
+    GstPad *tee_pad = NULL;
+    GstPad *src_pad = NULL;
+    gchar *name = NULL;
+
+    name = rct_gst_tap_get_element_name(tap_id, "tee");
+    tee = gst_bin_get_by_name(GST_BIN(self->pipeline), name);
+    g_free(name);
+
+    name = rct_gst_tap_get_element_name(tap_id, "queue");
+    queue = gst_bin_get_by_name(GST_BIN(self->pipeline), name);
+    g_free(name);
+
+    name = rct_gst_tap_get_element_name(tap_id, "appsink");
+    appsink = gst_bin_get_by_name(GST_BIN(self->pipeline), name);
+    g_free(name);
+
+    if (tee && queue && appsink) {
+        tee_pad = gst_element_get_static_pad(tee, "sink");
+        src_pad = gst_pad_get_peer(tee_pad);
+    }
+
+    if (src_pad) {
+        gst_pad_add_probe(src_pad, GST_PAD_PROBE_TYPE_IDLE, cb_remove_tap_branch,
+                          rct_gst_tap_branch_new(self, NULL, tee, queue, appsink),
+                          (GDestroyNotify) rct_gst_tap_branch_free);
+        gst_object_unref(src_pad);
+    }
+
+    if (tee_pad)
+        gst_object_unref(tee_pad);
+
+    if (tee)
+        gst_object_unref(tee);
+
+    if (queue)
+        gst_object_unref(queue);
+
+    if (appsink)
+        gst_object_unref(appsink);
+}
+
+static void cb_find_stale_tap(const GValue *item, gpointer user_data) {
+    GArray *tap_ids = (GArray *) user_data;
+    const gchar *name = GST_ELEMENT_NAME(g_value_get_object(item));
+    guint tap_id = 0;
+
+    if (g_str_has_prefix(name, "rct_gst_tap_") && g_str_has_suffix(name, "_tee")) {
+        tap_id = (guint) g_ascii_strtoull(name + strlen("rct_gst_tap_"), NULL, 10);
+        g_array_append_val(tap_ids, tap_id);
+    }
+}
+
+// Branches of taps removed while their pipeline was cached
+static void rct_gst_player_strip_frame_taps(RctGstPlayer *self) {
+    GstIterator *iterator = NULL;
+    GArray *tap_ids = NULL;
+    guint i = 0;
+    guint j = 0;
+
+    tap_ids = g_array_new(FALSE, FALSE, sizeof(guint));
+
+    iterator = gst_bin_iterate_elements(GST_BIN(self->pipeline));
+    gst_iterator_foreach(iterator, cb_find_stale_tap, tap_ids);
+    gst_iterator_free(iterator);
+
+    for (i = 0; i < tap_ids->len; i++) {
+        guint tap_id = g_array_index(tap_ids, guint, i);
+
+        for (j = 0; j < self->frame_taps->len; j++) {
+            if (((RctGstFrameTap *) g_ptr_array_index(self->frame_taps, j))->id == tap_id)
+                break;
+        }
+
+        if (j == self->frame_taps->len)
+            rct_gst_player_remove_tap_branch(self, tap_id);
+    }
+
+    g_array_unref(tap_ids);
+}
+
+// Called once the new pipeline is current
+static void rct_gst_player_attach_frame_taps(RctGstPlayer *self) {
+    guint i = 0;
+
+    if (self->pipeline)
+        rct_gst_player_strip_frame_taps(self);
+
+    for (i = 0; i < self->frame_taps->len; i++)
+        rct_gst_player_attach_frame_tap(self, g_ptr_array_index(self->frame_taps, i));
+}
+
+// Called before the current pipeline is released
+static void rct_gst_player_detach_frame_taps(RctGstPlayer *self) {
+    GstElement *appsink = NULL;
+    guint i = 0;
+
+    for (i = 0; i < self->frame_taps->len; i++) {
+        appsink = rct_gst_frame_tap_disarm(g_ptr_array_index(self->frame_taps, i), FALSE);
+
+        if (appsink)
+            gst_object_unref(appsink);
+    }
+}
+
+static void rct_gst_player_apply_frame_tap(RctGstPlayer *self, RctGstFrameTap *tap) {
+    g_mutex_lock(&self->stats_lock);
+    g_ptr_array_add(self->frame_taps, tap);
+    g_mutex_unlock(&self->stats_lock);
+
+    rct_gst_player_attach_frame_tap(self, tap);
+}
+
+static void rct_gst_player_apply_frame_tap_removal(RctGstPlayer *self, guint tap_id) {
+    RctGstFrameTap *tap = NULL;
+    GstElement *appsink = NULL;
+    guint i = 0;
+
+    g_mutex_lock(&self->stats_lock);
+
+    for (i = 0; i < self->frame_taps->len; i++) {
+        if (((RctGstFrameTap *) g_ptr_array_index(self->frame_taps, i))->id == tap_id) {
+            tap = rct_gst_frame_tap_ref(g_ptr_array_index(self->frame_taps, i));
+            g_ptr_array_remove_index(self->frame_taps, i);
+            break;
+        }
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (tap == NULL)
+        return;
+
+    // Never called back after this, even by frames already in the branch
+    appsink = rct_gst_frame_tap_disarm(tap, TRUE);
+
+    // A branch that isn't inserted yet sees the tap removed and is never inserted
+    if (appsink && self->pipeline)
+        rct_gst_player_remove_tap_branch(self, tap->id);
+
+    if (appsink)
+        gst_object_unref(appsink);
+
+    rct_gst_frame_tap_unref(tap);
+}
+
+guint rct_gst_player_add_frame_tap(RctGstPlayer *self,
+                                   const gchar *element_name,
+                                   gdouble max_rate,
+                                   guint max_in_flight,
+                                   RctGstFrameTapCallback callback,
+                                   gpointer user_data) {
+    RctGstFrameTap *tap = NULL;
+    RctGstCommand *command = NULL;
+
+    tap = g_malloc0(sizeof(RctGstFrameTap));
+    tap->ref_count = 1;
+    tap->id = (guint) g_atomic_int_add(&self->last_frame_tap_id, 1) + 1;
+    tap->element_name = g_strdup(element_name);
+    tap->min_interval = max_rate > 0 ? (gint64) (G_USEC_PER_SEC / max_rate) : 0;
+    tap->max_in_flight = (gint) MAX(max_in_flight, 1);
+    tap->callback = callback;
+    tap->user_data = user_data;
+    tap->self = self;
+    g_mutex_init(&tap->lock);
+
+    command = g_malloc0(sizeof(RctGstCommand));
+    command->type = RCT_GST_COMMAND_ADD_FRAME_TAP;
+    command->pointer = tap;
+    rct_gst_player_post_command(self, command);
+
+    return tap->id;
+}
+
+void rct_gst_player_remove_frame_tap(RctGstPlayer *self, guint tap_id) {
+    RctGstCommand *command = NULL;
+
+    command = g_malloc0(sizeof(RctGstCommand));
+    command->type = RCT_GST_COMMAND_REMOVE_FRAME_TAP;
+    command->value = tap_id;
+    rct_gst_player_post_command(self, command);
+}
+
+gboolean rct_gst_player_get_frame_tap_stats(RctGstPlayer *self,
+                                            guint tap_id,
+                                            guint64 *delivered,
+                                            guint64 *dropped) {
+    RctGstFrameTap *tap = NULL;
+    guint i = 0;
+
+    // The tap lock is taken while delivering, which accounts the callback under stats_lock
+    g_mutex_lock(&self->stats_lock);
+
+    for (i = 0; i < self->frame_taps->len && tap == NULL; i++) {
+        if (((RctGstFrameTap *) g_ptr_array_index(self->frame_taps, i))->id == tap_id)
+            tap = rct_gst_frame_tap_ref(g_ptr_array_index(self->frame_taps, i));
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (tap == NULL)
+        return FALSE;
+
+    g_mutex_lock(&tap->lock);
+
+    if (delivered)
+        *delivered = tap->delivered;
+
+    if (dropped)
+        *dropped = tap->dropped;
+
+    g_mutex_unlock(&tap->lock);
+
+    rct_gst_frame_tap_unref(tap);
+    return TRUE;
+}
+
+// Incremental reconfiguration
+#define RCT_GST_SIGNATURE_KEY "rct-gst-player-signature"
+
+// Linear run of elements (upstream first), each one having at most one sink and one src pad
+typedef struct {
+    GPtrArray *elements;
+} RctGstElementChain;
+
+// Segment of a running chain swapped from an idle pad probe
+typedef struct {
+    RctGstPlayer *self;
+    GstPipeline *pipeline;
+    GstElement *upstream;
+    GstElement *downstream;
+    GPtrArray *old_elements;
+    GPtrArray *new_elements;
+} RctGstSegmentSwap;
+
+// Tells whether the element name has been given by GstObject rather than by the launch string
+static gboolean rct_gst_player_is_generated_name(GstElement *element) {
+    const gchar *name = GST_ELEMENT_NAME(element);
+    const gchar *type_name = G_OBJECT_TYPE_NAME(element);
+    gsize prefix_length = strlen(name);
+    gchar *prefix = NULL;
+    gchar *expected_prefix = NULL;
+    gboolean is_generated = FALSE;
+
+    while (prefix_length > 0 && g_ascii_isdigit(name[prefix_length - 1]))
+        prefix_length--;
+
+    if (prefix_length == strlen(name))
+        return FALSE;
+
+    if (prefix_length > 0 && name[prefix_length - 1] == '-')
+        prefix_length--;
+
+    if (g_str_has_prefix(type_name, "Gst"))
+        type_name += 3;
+
+    prefix = g_strndup(name, prefix_length);
+    expected_prefix = g_ascii_strdown(type_name, -1);
+    is_generated = g_strcmp0(prefix, expected_prefix) == 0;
+
+    g_free(prefix);
+    g_free(expected_prefix);
+
+    return is_generated;
+}
+
+// Type, explicit name and non default properties of an element
+static gchar *rct_gst_player_compute_element_signature(GstElement *element) {
+    GString *signature = NULL;
+    GParamSpec **pspecs = NULL;
+    guint n_pspecs = 0;
+    guint i = 0;
+
+    signature = g_string_new(G_OBJECT_TYPE_NAME(element));
+
+    if (!rct_gst_player_is_generated_name(element))
+        g_string_append_printf(signature, " name=%s", GST_ELEMENT_NAME(element));
+
+    pspecs = g_object_class_list_properties(G_OBJECT_GET_CLASS(element), &n_pspecs);
+    for (i = 0; i < n_pspecs; i++) {
+        GParamSpec *pspec = pspecs[i];
+        GValue value = G_VALUE_INIT;
+        gchar *serialized_value = NULL;
+
+        if ((pspec->flags & G_PARAM_READWRITE) != G_PARAM_READWRITE)
+            continue;
+
+        if (pspec->owner_type == GST_TYPE_OBJECT) // name and parent
+            continue;
+
+        g_value_init(&value, pspec->value_type);
+        g_object_get_property(G_OBJECT(element), pspec->name, &value);
+
+        if (!g_param_value_defaults(pspec, &value))
+            serialized_value = gst_value_serialize(&value);
+
+        if (serialized_value)
+            g_string_append_printf(signature, " %s=%s", pspec->name, serialized_value);
+
+        g_free(serialized_value);
+        g_value_unset(&value);
+    }
+    g_free(pspecs);
+
+    return g_string_free(signature, FALSE);
+}
+
+// Signatures are computed once, right after parsing, so that properties set later don't count
+static const gchar *rct_gst_player_get_element_signature(GstElement *element) {
+    gchar *signature = NULL;
+
+    signature = g_object_get_data(G_OBJECT(element), RCT_GST_SIGNATURE_KEY);
+    if (signature == NULL) {
+        signature = rct_gst_player_compute_element_signature(element);
+        g_object_set_data_full(G_OBJECT(element), RCT_GST_SIGNATURE_KEY, signature, g_free);
+    }
+
+    return signature;
+}
+
+static void cb_sign_element(const GValue *item, gpointer user_data) {
+    (void) user_data;
+
+    rct_gst_player_get_element_signature(GST_ELEMENT(g_value_get_object(item)));
+}
+
+static void rct_gst_player_sign_pipeline(GstPipeline *pipeline) {
+    GstIterator *iterator = NULL;
+
+    iterator = gst_bin_iterate_elements(GST_BIN(pipeline));
+    gst_iterator_foreach(iterator, cb_sign_element, NULL);
+    gst_iterator_free(iterator);
+}
+
+// Only elements with always pads, all of them linked, can be moved around safely
+static gboolean rct_gst_player_element_is_static(GstElement *element) {
+    const GList *pad_templates = NULL;
+    gboolean is_static = TRUE;
+
+    pad_templates = gst_element_class_get_pad_template_list(GST_ELEMENT_GET_CLASS(element));
+    for (; pad_templates != NULL; pad_templates = pad_templates->next) {
+        if (GST_PAD_TEMPLATE_PRESENCE(pad_templates->data) != GST_PAD_ALWAYS)
+            return FALSE;
+    }
+
+    GST_OBJECT_LOCK(element);
+    if (element->numsinkpads > 1 || element->numsrcpads > 1)
+        is_static = FALSE;
+    else if (element->numsinkpads == 1 && !gst_pad_is_linked(element->sinkpads->data))
+        is_static = FALSE;
+    else if (element->numsrcpads == 1 && !gst_pad_is_linked(element->srcpads->data))
+        is_static = FALSE;
+    GST_OBJECT_UNLOCK(element);
+
+    return is_static;
+}
+
+static void rct_gst_element_chain_free(RctGstElementChain *chain) {
+    g_ptr_array_unref(chain->elements);
+    g_free(chain);
+}
+
+static const gchar *rct_gst_element_chain_get_signature(RctGstElementChain *chain, guint index) {
+    return rct_gst_player_get_element_signature(g_ptr_array_index(chain->elements, index));
+}
+
+static gboolean rct_gst_element_chain_equal(RctGstElementChain *chain, RctGstElementChain *other) {
+    guint i = 0;
+
+    if (chain->elements->len != other->elements->len)
+        return FALSE;
+
+    for (i = 0; i < chain->elements->len; i++) {
+        if (g_strcmp0(rct_gst_element_chain_get_signature(chain, i),
+                      rct_gst_element_chain_get_signature(other, i)) != 0)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+// Splits the top level of a pipeline into linear chains, NULL if its graph isn't made of chains only
+static GPtrArray *rct_gst_player_collect_chains(GstPipeline *pipeline) {
+    GPtrArray *chains = NULL;
+    GList *children = NULL;
+    GList *child = NULL;
+    guint n_elements = 0;
+    guint n_chained = 0;
+
+    chains = g_ptr_array_new_with_free_func((GDestroyNotify) rct_gst_element_chain_free);
+
+    GST_OBJECT_LOCK(pipeline);
+    children = g_list_copy_deep(GST_BIN_CHILDREN(pipeline), (GCopyFunc) gst_object_ref, NULL);
+    GST_OBJECT_UNLOCK(pipeline);
+
+    n_elements = g_list_length(children);
+
+    for (child = children; child != NULL; child = child->next) {
+        if (!rct_gst_player_element_is_static(child->data))
+            goto fail;
+    }
+
+    for (child = children; child != NULL; child = child->next) {
+        GstElement *element = child->data;
+        RctGstElementChain *chain = NULL;
+
+        if (element->numsinkpads > 0)
+            continue;
+
+        chain = g_malloc0(sizeof(RctGstElementChain));
+        chain->elements = g_ptr_array_new_with_free_func((GDestroyNotify) gst_object_unref);
+        g_ptr_array_add(chains, chain);
+
+        element = gst_object_ref(element);
+        while (element != NULL) {
+            GstPad *peer = NULL;
+
+            g_ptr_array_add(chain->elements, element);
+            n_chained++;
+
+            if (element->numsrcpads == 0)
+                break;
+
+            peer = gst_pad_get_peer(element->srcpads->data);
+            element = gst_pad_get_parent_element(peer);
+            gst_object_unref(peer);
+
+            if (element == NULL || GST_OBJECT_PARENT(element) != GST_OBJECT(pipeline)) {
+                if (element)
+                    gst_object_unref(element);
+                goto fail;
+            }
+        }
+    }
+
+    // Anything left is not reachable from a source
+    if (n_chained != n_elements)
+        goto fail;
+
+    g_list_free_full(children, (GDestroyNotify) gst_object_unref);
+    return chains;
+
+fail:
+    g_list_free_full(children, (GDestroyNotify) gst_object_unref);
+    g_ptr_array_unref(chains);
+    return NULL;
+}
+
+static void rct_gst_player_remove_chain(GstPipeline *pipeline, RctGstElementChain *chain) {
+    guint i = 0;
+
+    for (i = 0; i < chain->elements->len; i++) {
+        GstElement *element = g_ptr_array_index(chain->elements, i);
+
+        gst_element_set_state(element, GST_STATE_NULL);
+        gst_bin_remove(GST_BIN(pipeline), element);
+    }
+}
+
+static void rct_gst_player_move_chain(RctGstPlayer *self, GstPipeline *from, GstPipeline *to,
+                                      RctGstElementChain *chain) {
+    guint i = 0;
+
+    // Removing an element from its bin unlinks it, links are restored in the target pipeline
+    for (i = 0; i < chain->elements->len; i++) {
+        GstElement *element = g_ptr_array_index(chain->elements, i);
+
+        gst_bin_remove(GST_BIN(from), element);
+        gst_bin_add(GST_BIN(to), element);
+    }
+
+    for (i = 1; i < chain->elements->len; i++) {
+        GstElement *previous = g_ptr_array_index(chain->elements, i - 1);
+        GstElement *element = g_ptr_array_index(chain->elements, i);
+
+        if (!gst_element_link(previous, element))
+            RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_LINK_FAILED,
+                          GST_ELEMENT_NAME(previous), 0, GST_ELEMENT_NAME(element));
+    }
+
+    // Downstream first, so that sources never push into a stopped element
+    for (i = chain->elements->len; i > 0; i--)
+        gst_element_sync_state_with_parent(g_ptr_array_index(chain->elements, i - 1));
+}
+
+static GPtrArray *rct_gst_element_chain_slice(RctGstElementChain *chain, guint from, guint to) {
+    GPtrArray *elements = NULL;
+    guint i = 0;
+
+    elements = g_ptr_array_new_with_free_func((GDestroyNotify) gst_object_unref);
+    for (i = from; i < to; i++)
+        g_ptr_array_add(elements, gst_object_ref(g_ptr_array_index(chain->elements, i)));
+
+    return elements;
+}
+
+static void rct_gst_segment_swap_free(RctGstSegmentSwap *swap) {
+    g_object_unref(swap->self);
+    gst_object_unref(swap->pipeline);
+    gst_object_unref(swap->upstream);
+    gst_object_unref(swap->downstream);
+    g_ptr_array_unref(swap->old_elements);
+    g_ptr_array_unref(swap->new_elements);
+    g_free(swap);
+}
+
+// Chains sharing their first and last elements only get their middle segment swapped
+static RctGstSegmentSwap *rct_gst_segment_swap_new(RctGstPlayer *self,
+                                                   RctGstElementChain *old_chain,
+                                                   RctGstElementChain *new_chain) {
+    RctGstSegmentSwap *swap = NULL;
+    guint old_length = old_chain->elements->len;
+    guint new_length = new_chain->elements->len;
+    guint prefix = 0;
+    guint suffix = 0;
+
+    while (prefix < old_length && prefix < new_length &&
+           g_strcmp0(rct_gst_element_chain_get_signature(old_chain, prefix),
+                     rct_gst_element_chain_get_signature(new_chain, prefix)) == 0)
+        prefix++;
+
+    while (suffix < old_length - prefix && suffix < new_length - prefix &&
+           g_strcmp0(rct_gst_element_chain_get_signature(old_chain, old_length - suffix - 1),
+                     rct_gst_element_chain_get_signature(new_chain, new_length - suffix - 1)) == 0)
+        suffix++;
+
+    if (prefix == 0 || suffix == 0)
+        return NULL;
+
+    swap = g_malloc0(sizeof(RctGstSegmentSwap));
+    swap->self = g_object_ref(self);
+    swap->pipeline = gst_object_ref(self->pipeline);
+    swap->upstream = gst_object_ref(g_ptr_array_index(old_chain->elements, prefix - 1));
+    swap->downstream = gst_object_ref(g_ptr_array_index(old_chain->elements, old_length - suffix));
+    swap->old_elements = rct_gst_element_chain_slice(old_chain, prefix, old_length - suffix);
+    swap->new_elements = rct_gst_element_chain_slice(new_chain, prefix, new_length - suffix);
+
+    return swap;
+}
+
+static GstPadProbeReturn cb_swap_segment(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void) info;
+
+    RctGstSegmentSwap *swap = NULL;
+    GstElement *previous = NULL;
+    GstElement *video_sink = NULL;
+    GstPad *peer = NULL;
+    gpointer drawable_surface = NULL;
+    guint i = 0;
+
+    swap = (RctGstSegmentSwap *) user_data;
+
+    peer = gst_pad_get_peer(pad);
+    if (peer) {
+        gst_pad_unlink(pad, peer);
+        gst_object_unref(peer);
+    }
+
+    for (i = 0; i < swap->old_elements->len; i++) {
+        GstElement *element = g_ptr_array_index(swap->old_elements, i);
+
+        gst_element_set_state(element, GST_STATE_NULL);
+        gst_bin_remove(GST_BIN(swap->pipeline), element);
+    }
+
+    previous = swap->upstream;
+    for (i = 0; i < swap->new_elements->len; i++) {
+        GstElement *element = g_ptr_array_index(swap->new_elements, i);
+
+        gst_bin_add(GST_BIN(swap->pipeline), element);
+        if (!gst_element_link(previous, element))
+            RCT_GST_TRACE(swap->self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_LINK_FAILED,
+                          GST_ELEMENT_NAME(previous), 0, GST_ELEMENT_NAME(element));
+
+        previous = element;
+    }
+
+    if (!gst_element_link(previous, swap->downstream))
+        RCT_GST_TRACE(swap->self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_LINK_FAILED,
+                      GST_ELEMENT_NAME(previous), 0, GST_ELEMENT_NAME(swap->downstream));
+
+    for (i = swap->new_elements->len; i > 0; i--)
+        gst_element_sync_state_with_parent(g_ptr_array_index(swap->new_elements, i - 1));
+
+    g_atomic_int_set(&swap->self->element_targets_stale, TRUE);
+
+    // Streaming thread : only the swapped in sinks are bound, the player pipelines belong to its context
+    drawable_surface = g_atomic_pointer_get(&swap->self->drawable_surface);
+    for (i = 0; drawable_surface && i < swap->new_elements->len; i++) {
+        GstElement *element = g_ptr_array_index(swap->new_elements, i);
+
+        if (GST_IS_VIDEO_OVERLAY(element))
+            video_sink = gst_object_ref(element);
+        else if (GST_IS_BIN(element))
+            video_sink = gst_bin_get_by_interface(GST_BIN(element), GST_TYPE_VIDEO_OVERLAY);
+
+        if (video_sink == NULL)
+            continue;
+
+        gst_video_overlay_set_window_handle(GST_VIDEO_OVERLAY(video_sink), (guintptr) drawable_surface);
+        gst_object_unref(video_sink);
+        video_sink = NULL;
+    }
+
+    RCT_GST_TRACE(swap->self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_SEGMENT_SWAPPED,
+                  GST_ELEMENT_NAME(swap->upstream), swap->new_elements->len,
+                  GST_ELEMENT_NAME(swap->downstream));
+
+    return GST_PAD_PROBE_REMOVE;
+}
+
+static void rct_gst_player_apply_segment_swap(GstPipeline *new_pipeline, RctGstSegmentSwap *swap) {
+    GstPad *src_pad = NULL;
+    guint i = 0;
+
+    for (i = 0; i < swap->new_elements->len; i++)
+        gst_bin_remove(GST_BIN(new_pipeline), g_ptr_array_index(swap->new_elements, i));
+
+    // Fires right away when the pad is idle, or as soon as the current buffer has been pushed
+    src_pad = swap->upstream->srcpads->data;
+    gst_pad_add_probe(src_pad, GST_PAD_PROBE_TYPE_IDLE, cb_swap_segment, swap,
+                      (GDestroyNotify) rct_gst_segment_swap_free);
+}
+
+// Moves into the running pipeline only the chains of new_pipeline that differ.
+// Returns FALSE when nothing can be kept, new_pipeline is then left untouched.
+static gboolean rct_gst_player_reconfigure_pipeline(RctGstPlayer *self, GstPipeline *new_pipeline) {
+    GPtrArray *old_chains = NULL;
+    GPtrArray *new_chains = NULL;
+    GPtrArray *swaps = NULL;
+    gboolean *old_kept = NULL;
+    gboolean *new_used = NULL;
+    gboolean reconfigured = FALSE;
+    guint i = 0;
+    guint j = 0;
+
+    // A single element launch string (playbin...) has no segments to reuse
+    if (G_OBJECT_TYPE(self->pipeline) != GST_TYPE_PIPELINE ||
+        G_OBJECT_TYPE(new_pipeline) != GST_TYPE_PIPELINE)
+        return FALSE;
+
+    old_chains = rct_gst_player_collect_chains(self->pipeline);
+    new_chains = rct_gst_player_collect_chains(new_pipeline);
+    if (old_chains == NULL || new_chains == NULL)
+        goto done;
+
+    old_kept = g_new0(gboolean, old_chains->len);
+    new_used = g_new0(gboolean, new_chains->len);
+    swaps = g_ptr_array_new_with_free_func((GDestroyNotify) rct_gst_segment_swap_free);
+
+    // Unchanged chains keep running
+    for (j = 0; j < new_chains->len; j++) {
+        for (i = 0; i < old_chains->len; i++) {
+            if (!old_kept[i] &&
+                rct_gst_element_chain_equal(g_ptr_array_index(old_chains, i),
+                                            g_ptr_array_index(new_chains, j))) {
+                old_kept[i] = new_used[j] = TRUE;
+                break;
+            }
+        }
+    }
+
+    // Chains only differing in their middle get this segment swapped
+    for (j = 0; j < new_chains->len; j++) {
+        for (i = 0; i < old_chains->len && !new_used[j]; i++) {
+            RctGstSegmentSwap *swap = NULL;
+
+            if (old_kept[i])
+                continue;
+
+            swap = rct_gst_segment_swap_new(self,
+                                            g_ptr_array_index(old_chains, i),
+                                            g_ptr_array_index(new_chains, j));
+            if (swap) {
+                g_ptr_array_add(swaps, swap);
+                old_kept[i] = new_used[j] = TRUE;
+            }
+        }
+    }
+
+    for (i = 0; i < old_chains->len; i++)
+        reconfigured |= old_kept[i];
+
+    if (!reconfigured)
+        goto done;
+
+    for (i = 0; i < old_chains->len; i++) {
+        if (!old_kept[i])
+            rct_gst_player_remove_chain(self->pipeline, g_ptr_array_index(old_chains, i));
+    }
+
+    for (j = 0; j < new_chains->len; j++) {
+        if (!new_used[j])
+            rct_gst_player_move_chain(self, new_pipeline, self->pipeline,
+                                      g_ptr_array_index(new_chains, j));
+    }
+
+    // Swaps are owned by their pad probe from now on
+    for (i = 0; i < swaps->len; i++)
+        rct_gst_player_apply_segment_swap(new_pipeline, g_ptr_array_index(swaps, i));
+    g_ptr_array_set_free_func(swaps, NULL);
+
+    if (self->drawable_surface)
+        rct_gst_player_set_drawable_surface(self, self->drawable_surface);
+
+done:
+    if (swaps)
+        g_ptr_array_unref(swaps);
+    if (old_chains)
+        g_ptr_array_unref(old_chains);
+    if (new_chains)
+        g_ptr_array_unref(new_chains);
+    g_free(old_kept);
+    g_free(new_used);
+
+    return reconfigured;
+}
+
+static void rct_gst_player_set_parse_launch_pipeline(RctGstPlayer *self,
+                                                     gchar *parse_launch_pipeline) {
+    GstPipeline *pipeline = NULL;
+    gint64 launch_time = g_get_monotonic_time();
+
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PARSE_LAUNCH_PIPELINE, NULL, 0,
+                  parse_launch_pipeline);
+
+    pipeline = rct_gst_player_take_preloaded_pipeline(self, parse_launch_pipeline);
+    if (pipeline == NULL)
+        pipeline = rct_gst_player_take_cached_pipeline(self, parse_launch_pipeline);
+
+    if (pipeline) {
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PIPELINE_REUSED,
+                      GST_ELEMENT_NAME(pipeline), 0, NULL);
+
+    } else if (self->pipeline && self->incremental_reconfiguration) {
+        pipeline = GST_PIPELINE(gst_parse_launch(parse_launch_pipeline, NULL));
+        rct_gst_player_handle_bus(pipeline);
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PIPELINE_CREATED,
+                      pipeline ? GST_ELEMENT_NAME(pipeline) : NULL, 0, NULL);
+
+        // The pipeline keeps running : seeks, buffering and position are those of the current one,
+        // and the latency profile and memory budget get the added elements. Startup is measured
+        // again and only frame taps of the swapped chains are inserted again.
+        if (pipeline && rct_gst_player_reconfigure_pipeline(self, pipeline)) {
+            RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PIPELINE_RECONFIGURED,
+                          GST_ELEMENT_NAME(self->pipeline), 0, NULL);
+
+            gst_element_set_state(GST_ELEMENT(pipeline), GST_STATE_NULL);
+            gst_object_unref(pipeline);
+
+            g_free(self->parse_launch_pipeline);
+            self->parse_launch_pipeline = parse_launch_pipeline;
+
+            rct_gst_player_flush_property_writes(self);
+            rct_gst_player_reset_element_targets(self);
+            rct_gst_player_rewatch_startup(self, launch_time);
+            rct_gst_player_attach_frame_taps(self);
+            return;
+        }
+    }
+
+    // Released before parsing, so that an asynchronous teardown overlaps with the new build
+    if (self->pipeline) {
+        GstPipeline *old_pipeline = self->pipeline;
+
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PIPELINE_RELEASED,
+                      GST_ELEMENT_NAME(old_pipeline), 0, NULL);
+
+        rct_gst_player_clear_startup_probes(self);
+        rct_gst_player_clear_latency_profile(self);
+        rct_gst_player_clear_memory_budget(self);
+        rct_gst_player_unwatch_playlist(self);
+        rct_gst_player_detach_frame_taps(self);
+        rct_gst_player_reset_seeks(self);
+        rct_gst_player_reset_buffering(self);
+        rct_gst_player_clear_source(&self->position_source);
+        rct_gst_player_reset_position(self);
+
+        g_mutex_lock(&self->stats_lock);
+        self->pipeline = NULL;
+        g_hash_table_remove_all(self->qos_stats);
+        g_mutex_unlock(&self->stats_lock);
+
+        rct_gst_player_unwatch_bus(self);
+        rct_gst_player_release_pipeline(self, self->parse_launch_pipeline, old_pipeline);
+        rct_gst_player_reset_element_targets(self);
+    }
+
+    if (pipeline == NULL) {
+        pipeline = GST_PIPELINE(gst_parse_launch(parse_launch_pipeline, NULL));
+        rct_gst_player_handle_bus(pipeline);
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PIPELINE_CREATED,
+                      pipeline ? GST_ELEMENT_NAME(pipeline) : NULL, 0, NULL);
+    }
+
+    g_free(self->parse_launch_pipeline);
+    self->parse_launch_pipeline = parse_launch_pipeline;
+
+    g_mutex_lock(&self->stats_lock);
+    self->pipeline = pipeline;
+    g_mutex_unlock(&self->stats_lock);
+
+    if (self->incremental_reconfiguration)
+        rct_gst_player_sign_pipeline(self->pipeline);
+
+    rct_gst_player_reset_element_targets(self);
+    rct_gst_player_watch_bus(self);
+    rct_gst_player_watch_startup(self, launch_time);
+    rct_gst_player_apply_latency_profile(self);
+    rct_gst_player_apply_buffering_mode(self);
+    rct_gst_player_apply_memory_budget(self);
+    rct_gst_player_watch_playlist(self);
+    rct_gst_player_attach_frame_taps(self);
+
+    rct_gst_player_set_desired_state(self, self->desired_state);
+}
+
+static void rct_gst_player_set_element_value(RctGstPlayer *self,
+                                             const gchar *element_name,
+                                             const gchar *property_name,
+                                             const GValue *value) {
+    RctGstPropertyTarget *target = NULL;
+    GValue converted = G_VALUE_INIT;
+
+    target = rct_gst_player_resolve_property(self, element_name, property_name);
+    if (target == NULL)
+        return;
+
+    // Values of the right type are written as is
+    if (G_VALUE_TYPE(value) == G_PARAM_SPEC_VALUE_TYPE(target->pspec)) {
+        rct_gst_player_write_property(self, target, value);
+        return;
+    }
+
+    if (!rct_gst_player_convert_value(value, target->pspec, &converted)) {
+        rct_gst_player_report_property_error(
+                self, g_strdup_printf("Invalid value for property %s on element %s",
+                                      property_name, element_name));
+        return;
+    }
+
+    rct_gst_player_write_property(self, target, &converted);
+    g_value_unset(&converted);
+}
+
+static void rct_gst_player_set_element_property(RctGstPlayer *self,
+                                                const gchar *element_name,
+                                                const gchar *property_name,
+                                                JsonNode *property_node) {
+    GValue value = G_VALUE_INIT;
+
+    json_node_get_value(property_node, &value);
+    rct_gst_player_set_element_value(self, element_name, property_name, &value);
+    g_value_unset(&value);
+}
+
+void rct_gst_player_lookup_properties(RctGstPlayer *self,
+                                      JsonNode *node,
+                                      const gchar *element_name,
+                                      const gchar *property_name) {
+    GType node_type = json_node_get_value_type(node);
+
+    if (element_name != NULL && property_name != NULL) {
+        rct_gst_player_set_element_property(self, element_name, property_name, node);
+    }
+
+    if (node_type == JSON_TYPE_OBJECT) {
+        JsonObject *object = NULL;
+        JsonObjectIter object_iterator;
+        const gchar *member_name;
+        JsonNode *member_node = NULL;
+
+        object = json_node_get_object(node);
+        json_object_iter_init(&object_iterator, object);
+
+        while (json_object_iter_next(&object_iterator, &member_name, &member_node)) {
+            if (element_name != NULL)
+                rct_gst_player_lookup_properties(self, member_node, element_name, member_name);
+            else
+                rct_gst_player_lookup_properties(self, member_node, member_name, NULL);
+        }
+    }
+}
+
+static void rct_gst_player_apply_pipeline_properties(RctGstPlayer *self,
+                                                    const gchar *pipeline_properties) {
+
+    JsonParser *parser = NULL;
+    GError *error = NULL;
+    JsonNode *elements_node = NULL;
+
+    parser = json_parser_new();
+    json_parser_load_from_data(parser, pipeline_properties, -1, &error);
+    if (error != NULL) {
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_ERROR, "pipeline_properties",
+                      0, error->message);
+
+        g_error_free(error);
+        g_object_unref(parser);
+        return;
+    }
+
+    elements_node = json_parser_get_root(parser);
+    rct_gst_player_lookup_properties(self, elements_node, NULL, NULL);
+
+    g_object_unref(parser);
+}
+
+void rct_gst_player_set_pipeline_properties(RctGstPlayer *self, const gchar *pipeline_properties) {
+    rct_gst_player_post_pipeline_properties(self, pipeline_properties, NULL, NULL);
+}
+
+// Typed property writes
+struct _RctGstPropertyBatch {
+    GArray *entries; // RctGstPropertyEntry, owning their names and values
+};
+
+static void rct_gst_property_entry_clear(RctGstPropertyEntry *entry) {
+    g_free((gchar *) entry->element_name);
+    g_free((gchar *) entry->property_name);
+    g_value_unset(&entry->value);
+}
+
+RctGstPropertyBatch *rct_gst_property_batch_new(void) {
+    RctGstPropertyBatch *batch = NULL;
+
+    batch = g_malloc0(sizeof(RctGstPropertyBatch));
+    batch->entries = g_array_new(FALSE, TRUE, sizeof(RctGstPropertyEntry));
+    g_array_set_clear_func(batch->entries, (GDestroyNotify) rct_gst_property_entry_clear);
+
+    return batch;
+}
+
+void rct_gst_property_batch_free(RctGstPropertyBatch *batch) {
+    g_array_unref(batch->entries);
+    g_free(batch);
+}
+
+static GValue *rct_gst_property_batch_add_entry(RctGstPropertyBatch *batch,
+                                                const gchar *element_name,
+                                                const gchar *property_name,
+                                                GType type) {
+    RctGstPropertyEntry *entry = NULL;
+
+    g_array_set_size(batch->entries, batch->entries->len + 1);
+
+    entry = &g_array_index(batch->entries, RctGstPropertyEntry, batch->entries->len - 1);
+    entry->element_name = g_strdup(element_name);
+    entry->property_name = g_strdup(property_name);
+    g_value_init(&entry->value, type);
+
+    return &entry->value;
+}
+
+void rct_gst_property_batch_add_value(RctGstPropertyBatch *batch,
+                                      const gchar *element_name,
+                                      const gchar *property_name,
+                                      const GValue *value) {
+    g_value_copy(value, rct_gst_property_batch_add_entry(batch, element_name, property_name,
+                                                         G_VALUE_TYPE(value)));
+}
+
+void rct_gst_property_batch_add_int(RctGstPropertyBatch *batch,
+                                    const gchar *element_name,
+                                    const gchar *property_name,
+                                    gint64 value) {
+    g_value_set_int64(rct_gst_property_batch_add_entry(batch, element_name, property_name,
+                                                       G_TYPE_INT64), value);
+}
+
+void rct_gst_property_batch_add_double(RctGstPropertyBatch *batch,
+                                       const gchar *element_name,
+                                       const gchar *property_name,
+                                       gdouble value) {
+    g_value_set_double(rct_gst_property_batch_add_entry(batch, element_name, property_name,
+                                                        G_TYPE_DOUBLE), value);
+}
+
+void rct_gst_property_batch_add_boolean(RctGstPropertyBatch *batch,
+                                        const gchar *element_name,
+                                        const gchar *property_name,
+                                        gboolean value) {
+    g_value_set_boolean(rct_gst_property_batch_add_entry(batch, element_name, property_name,
+                                                         G_TYPE_BOOLEAN), value);
+}
+
+void rct_gst_property_batch_add_string(RctGstPropertyBatch *batch,
+                                       const gchar *element_name,
+                                       const gchar *property_name,
+                                       const gchar *value) {
+    g_value_set_string(rct_gst_property_batch_add_entry(batch, element_name, property_name,
+                                                        G_TYPE_STRING), value);
+}
+
+static void rct_gst_player_apply_property_batch(RctGstPlayer *self, RctGstPropertyBatch *batch) {
+    guint i = 0;
+
+    for (i = 0; i < batch->entries->len; i++) {
+        RctGstPropertyEntry *entry = &g_array_index(batch->entries, RctGstPropertyEntry, i);
+
+        rct_gst_player_set_element_value(self, entry->element_name, entry->property_name,
+                                         &entry->value);
+    }
+
+    rct_gst_property_batch_free(batch);
+}
+
+void rct_gst_player_set_properties(RctGstPlayer *self,
+                                   const RctGstPropertyEntry *entries,
+                                   guint n_entries) {
+    RctGstPropertyBatch *batch = NULL;
+    guint i = 0;
+
+    batch = rct_gst_property_batch_new();
+    for (i = 0; i < n_entries; i++)
+        rct_gst_property_batch_add_value(batch, entries[i].element_name, entries[i].property_name,
+                                         &entries[i].value);
+
+    rct_gst_player_post_property_batch(self, batch, NULL, NULL);
+}
+
+void rct_gst_player_set_property_value(RctGstPlayer *self,
+                                       const gchar *element_name,
+                                       const gchar *property_name,
+                                       const GValue *value) {
+    RctGstPropertyBatch *batch = NULL;
+
+    batch = rct_gst_property_batch_new();
+    rct_gst_property_batch_add_value(batch, element_name, property_name, value);
+
+    rct_gst_player_post_property_batch(self, batch, NULL, NULL);
+}
+
+// Statistics snapshots
+static void rct_gst_queue_stats_clear(RctGstQueueStats *queue_stats) {
+    g_free(queue_stats->element_name);
+}
+
+static gboolean rct_gst_element_has_property(GstElement *element, const gchar *property_name) {
+    return g_object_class_find_property(G_OBJECT_GET_CLASS(element), property_name) != NULL;
+}
+
+// queue, queue2 and multiqueue
+static gboolean rct_gst_element_is_queue(GstElement *element) {
+    return rct_gst_element_has_property(element, "max-size-bytes") &&
+           rct_gst_element_has_property(element, "max-size-buffers");
+}
+
+static void cb_sum_queue_levels(const GValue *item, gpointer user_data) {
+    RctGstQueueStats *levels = (RctGstQueueStats *) user_data;
+    GstPad *pad = GST_PAD(g_value_get_object(item));
+    guint buffers = 0;
+    guint bytes = 0;
+    guint64 time = 0;
+
+    if (g_object_class_find_property(G_OBJECT_GET_CLASS(pad), "current-level-bytes") == NULL)
+        return;
+
+    g_object_get(pad,
+                 "current-level-buffers", &buffers,
+                 "current-level-bytes", &bytes,
+                 "current-level-time", &time,
+                 NULL);
+
+    levels->buffers += buffers;
+    levels->bytes += bytes;
+    levels->time += time;
+}
+
+// Returns the number of queues held by the element : multiqueue levels are those of its pads
+// (GStreamer >= 1.18), and its limits apply to each of them
+static guint rct_gst_queue_get_levels(GstElement *element, RctGstQueueStats *levels) {
+    GstIterator *iterator = NULL;
+    guint n_queues = 0;
+
+    if (rct_gst_element_has_property(element, "current-level-bytes")) {
+        g_object_get(element,
+                     "current-level-buffers", &levels->buffers,
+                     "current-level-bytes", &levels->bytes,
+                     "current-level-time", &levels->time,
+                     NULL);
+        return 1;
+    }
+
+    iterator = gst_element_iterate_sink_pads(element);
+    gst_iterator_foreach(iterator, cb_sum_queue_levels, levels);
+    gst_iterator_free(iterator);
+
+    GST_OBJECT_LOCK(element);
+    n_queues = element->numsinkpads;
+    GST_OBJECT_UNLOCK(element);
+
+    return MAX(n_queues, 1);
+}
+
+static void cb_collect_element_stats(const GValue *item, gpointer user_data) {
+    RctGstPlayerStats *stats = (RctGstPlayerStats *) user_data;
+    GstElement *element = GST_ELEMENT(g_value_get_object(item));
+
+    if (rct_gst_element_is_queue(element)) {
+        RctGstQueueStats queue_stats = {0};
+        guint n_queues = 0;
+        guint64 max_size_time = 0;
+
+        queue_stats.element_name = g_strdup(GST_ELEMENT_NAME(element));
+        n_queues = rct_gst_queue_get_levels(element, &queue_stats);
+        g_object_get(element,
+                     "max-size-buffers", &queue_stats.max_buffers,
+                     "max-size-bytes", &queue_stats.max_bytes,
+                     "max-size-time", &max_size_time,
+                     NULL);
+        queue_stats.max_buffers = (guint) MIN((guint64) queue_stats.max_buffers * n_queues, G_MAXUINT);
+        queue_stats.max_bytes = (guint) MIN((guint64) queue_stats.max_bytes * n_queues, G_MAXUINT);
+        queue_stats.max_time = max_size_time * n_queues;
+
+        stats->buffered_bytes += queue_stats.bytes;
+        g_array_append_val(stats->queues, queue_stats);
+    }
+
+    // Sinks keep their own counters (GStreamer >= 1.18), more accurate than QoS messages
+    if (GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK) &&
+        rct_gst_element_has_property(element, "stats")) {
+        GstStructure *sink_stats = NULL;
+        guint64 rendered = 0;
+        guint64 dropped = 0;
+
+        g_object_get(element, "stats", &sink_stats, NULL);
+        if (sink_stats &&
+            gst_structure_get_uint64(sink_stats, "rendered", &rendered) &&
+            gst_structure_get_uint64(sink_stats, "dropped", &dropped)) {
+            if (!stats->sink_counters) {
+                stats->rendered_frames = 0;
+                stats->dropped_frames = 0;
+                stats->sink_counters = TRUE;
+            }
+
+            stats->rendered_frames += rendered;
+            stats->dropped_frames += dropped;
+        }
+
+        if (sink_stats)
+            gst_structure_free(sink_stats);
+    }
+}
+
+RctGstPlayerStats *rct_gst_player_get_stats(RctGstPlayer *self) {
+    RctGstPlayerStats *stats = NULL;
+    GstPipeline *pipeline = NULL;
+    GHashTableIter iterator;
+    RctGstQosStats *qos_stats = NULL;
+
+    stats = g_malloc0(sizeof(RctGstPlayerStats));
+    stats->queues = g_array_new(FALSE, TRUE, sizeof(RctGstQueueStats));
+    g_array_set_clear_func(stats->queues, (GDestroyNotify) rct_gst_queue_stats_clear);
+
+    g_mutex_lock(&self->stats_lock);
+
+    if (self->start_time)
+        stats->uptime = g_get_monotonic_time() - self->start_time;
+
+    g_hash_table_iter_init(&iterator, self->qos_stats);
+    while (g_hash_table_iter_next(&iterator, NULL, (gpointer *) &qos_stats)) {
+        stats->rendered_frames += qos_stats->processed;
+        stats->dropped_frames += qos_stats->dropped;
+    }
+
+    memcpy(stats->bus_messages, self->bus_messages, sizeof(stats->bus_messages));
+    memcpy(stats->callbacks, self->callback_stats, sizeof(stats->callbacks));
+    memcpy(stats->state_change_durations, self->state_change_durations,
+           sizeof(stats->state_change_durations));
+    stats->startup = self->startup_timings;
+    stats->measured_latency = self->measured_latency;
+    stats->max_measured_latency = self->max_measured_latency;
+    stats->rebuffers = self->rebuffers;
+    stats->buffering_time = self->buffering_time;
+    stats->max_buffered_bytes = self->max_buffered_bytes;
+    stats->memory_budget = self->pipeline_memory_budget;
+
+    if (self->pipeline)
+        pipeline = gst_object_ref(self->pipeline);
+
+    g_mutex_unlock(&self->stats_lock);
+
+    // Queries and properties are thread safe, the pipeline is only kept alive
+    if (pipeline) {
+        GstQuery *query = NULL;
+        GstIterator *elements = NULL;
+
+        query = gst_query_new_latency();
+        if (gst_element_query(GST_ELEMENT(pipeline), query))
+            gst_query_parse_latency(query, &stats->live, &stats->min_latency, &stats->max_latency);
+        gst_query_unref(query);
+
+        elements = gst_bin_iterate_recurse(GST_BIN(pipeline));
+        gst_iterator_foreach(elements, cb_collect_element_stats, stats);
+        gst_iterator_free(elements);
+
+        gst_object_unref(pipeline);
+    }
+
+    return stats;
+}
+
+void rct_gst_player_stats_free(RctGstPlayerStats *stats) {
+    g_array_unref(stats->queues);
+    g_free(stats);
+}
+
+static gboolean cb_push_stats(gpointer data) {
+    RctGstPlayer *self = NULL;
+    RctGstPlayerStats *stats = NULL;
+
+    self = (RctGstPlayer *) data;
+
+    if (self->on_rct_gst_player_stats) {
+        stats = rct_gst_player_get_stats(self);
+        self->on_rct_gst_player_stats(self, stats);
+        rct_gst_player_stats_free(stats);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+static void rct_gst_player_schedule_stats(RctGstPlayer *self) {
+    rct_gst_player_clear_source(&self->stats_source);
+
+    if (self->context && self->stats_interval > 0)
+        self->stats_source = rct_gst_player_attach_source(self,
+                                                          g_timeout_source_new(self->stats_interval),
+                                                          cb_push_stats,
+                                                          self);
+}
+
+static void rct_gst_player_apply_stats_interval(RctGstPlayer *self, guint stats_interval) {
+    self->stats_interval = stats_interval;
+    rct_gst_player_schedule_stats(self);
+}
+
+// Live low latency
+// Latency from the running time of each buffer to its rendering by a sink
+static GstPadProbeReturn cb_measure_latency(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    RctGstLatencyProbeData *data = (RctGstLatencyProbeData *) user_data;
+    RctGstPlayer *self = data->self;
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    GstElement *sink = GST_ELEMENT(GST_PAD_PARENT(pad));
+    GstEvent *event = NULL;
+    GstClock *clock = NULL;
+    const GstSegment *segment = NULL;
+    GstClockTime running_time = GST_CLOCK_TIME_NONE;
+    GstClockTime render_time = GST_CLOCK_TIME_NONE;
+
+    if (!GST_BUFFER_PTS_IS_VALID(buffer))
+        return GST_PAD_PROBE_OK;
+
+    event = gst_pad_get_sticky_event(pad, GST_EVENT_SEGMENT, 0);
+    if (event == NULL)
+        return GST_PAD_PROBE_OK;
+
+    gst_event_parse_segment(event, &segment);
+    if (segment->format == GST_FORMAT_TIME)
+        running_time = gst_segment_to_running_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buffer));
+    gst_event_unref(event);
+
+    clock = gst_element_get_clock(sink);
+    if (clock == NULL || !GST_CLOCK_TIME_IS_VALID(running_time))
+        goto out;
+
+    render_time = gst_clock_get_time(clock) - gst_element_get_base_time(sink);
+
+    // Synchronised sinks hold the buffer until its running time plus the pipeline latency
+    if (GST_IS_BASE_SINK(sink) && gst_base_sink_get_sync(GST_BASE_SINK(sink)))
+        render_time = MAX(render_time, running_time + gst_base_sink_get_latency(GST_BASE_SINK(sink)));
+
+    if (render_time >= running_time) {
+        g_mutex_lock(&self->stats_lock);
+
+        if (data->generation == self->latency_generation) {
+            self->measured_latency = render_time - running_time;
+            if (!GST_CLOCK_TIME_IS_VALID(self->max_measured_latency) ||
+                self->measured_latency > self->max_measured_latency)
+                self->max_measured_latency = self->measured_latency;
+        }
+
+        g_mutex_unlock(&self->stats_lock);
+    }
+
+out:
+    if (clock)
+        gst_object_unref(clock);
+
+    return GST_PAD_PROBE_OK;
+}
+
+static void rct_gst_player_measure_latency(RctGstPlayer *self, GstElement *sink) {
+    RctGstPadProbe *probe = NULL;
+    RctGstLatencyProbeData *data = NULL;
+    GstPad *pad = NULL;
+
+    pad = gst_element_get_static_pad(sink, "sink");
+    if (pad == NULL)
+        return;
+
+    probe = g_malloc0(sizeof(RctGstPadProbe));
+    probe->pad = pad;
+
+    data = g_malloc0(sizeof(RctGstLatencyProbeData));
+    data->self = self;
+
+    g_mutex_lock(&self->stats_lock);
+
+    data->generation = self->latency_generation;
+    probe->probe_id = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, cb_measure_latency, data, g_free);
+    g_ptr_array_add(self->latency_probes, probe);
+
+    g_mutex_unlock(&self->stats_lock);
+}
+
+// Known element types only : leaky short queues, short jitterbuffers dropping late packets,
+// sliced decoding, and sinks rendering as soon as possible
+static void rct_gst_player_tune_element(RctGstPlayer *self, GstElement *element) {
+    GParamSpec *pspec = NULL;
+    gboolean tuned = FALSE;
+
+    // Frame tap branches are leaky already
+    if (g_str_has_prefix(GST_ELEMENT_NAME(element), "rct_gst_tap_"))
+        return;
+
+    // queue
+    if (rct_gst_element_has_property(element, "leaky") &&
+        rct_gst_element_has_property(element, "max-size-buffers")) {
+        gst_util_set_object_arg(G_OBJECT(element), "leaky", "downstream");
+        g_object_set(element,
+                     "max-size-buffers", 2,
+                     "max-size-bytes", 0,
+                     "max-size-time", (guint64) 0,
+                     NULL);
+        tuned = TRUE;
+    }
+
+    // rtpjitterbuffer, rtpbin, rtspsrc, webrtcbin : milliseconds of jitter absorbed
+    pspec = g_object_class_find_property(G_OBJECT_GET_CLASS(element), "latency");
+    if (pspec && pspec->value_type == G_TYPE_UINT && (pspec->flags & G_PARAM_WRITABLE)) {
+        g_object_set(element, "latency", self->live_latency, NULL);
+        tuned = TRUE;
+    }
+
+    if (rct_gst_element_has_property(element, "drop-on-latency")) {
+        g_object_set(element, "drop-on-latency", TRUE, NULL);
+        tuned = TRUE;
+    }
+
+    // Frame threading delays the output by as many frames as there are threads
+    if (GST_IS_VIDEO_DECODER(element)) {
+        if (rct_gst_element_has_property(element, "thread-type"))
+            gst_util_set_object_arg(G_OBJECT(element), "thread-type", "slice");
+        if (rct_gst_element_has_property(element, "low-latency"))
+            g_object_set(element, "low-latency", TRUE, NULL);
+        tuned = TRUE;
+    }
+
+    // Bins holding sinks are flagged as sinks too
+    if (GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK) && !GST_IS_BIN(element)) {
+        if (rct_gst_element_has_property(element, "buffer-time")) {
+            // Audio sinks keep their clock, with a ring buffer as short as devices allow
+            g_object_set(element,
+                         "buffer-time", (gint64) 40000,
+                         "latency-time", (gint64) 10000,
+                         NULL);
+        } else if (rct_gst_element_has_property(element, "sync")) {
+            g_object_set(element, "sync", FALSE, NULL);
+        }
+
+        rct_gst_player_measure_latency(self, element);
+        tuned = TRUE;
+    }
+
+    if (tuned)
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_DEBUG, RCT_GST_TRACE_ELEMENT_TUNED,
+                      GST_ELEMENT_NAME(element), 0, NULL);
+}
+
+static void cb_tune_element(const GValue *item, gpointer user_data) {
+    rct_gst_player_tune_element((RctGstPlayer *) user_data, GST_ELEMENT(g_value_get_object(item)));
+}
+
+// Elements created later on (rtspsrc, decodebin, webrtcbin...)
+static void cb_latency_element_added(GstBin *bin, GstBin *sub_bin, GstElement *element, gpointer user_data) {
+    (void) sub_bin;
+
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+    gboolean current = FALSE;
+
+    g_mutex_lock(&self->stats_lock);
+    current = GST_ELEMENT(bin) == GST_ELEMENT(self->pipeline);
+    g_mutex_unlock(&self->stats_lock);
+
+    if (current)
+        rct_gst_player_tune_element(self, element);
+}
+
+// Called once the new pipeline is current
+static void rct_gst_player_apply_latency_profile(RctGstPlayer *self) {
+    GstIterator *iterator = NULL;
+
+    if (!self->live_low_latency || self->pipeline == NULL)
+        return;
+
+    g_mutex_lock(&self->stats_lock);
+    self->measured_latency = GST_CLOCK_TIME_NONE;
+    self->max_measured_latency = GST_CLOCK_TIME_NONE;
+    g_mutex_unlock(&self->stats_lock);
+
+    g_object_set_data(G_OBJECT(self->pipeline), RCT_GST_LOW_LATENCY_KEY, GINT_TO_POINTER(TRUE));
+
+    self->latency_element_added_handler = g_signal_connect(self->pipeline, "deep-element-added",
+                                                           G_CALLBACK(cb_latency_element_added),
+                                                           self);
+
+    iterator = gst_bin_iterate_recurse(GST_BIN(self->pipeline));
+    gst_iterator_foreach(iterator, cb_tune_element, self);
+    gst_iterator_free(iterator);
+}
+
+// Elements keep their settings : a cached pipeline is tuned already, and only reused while the
+// profile is on
+static void rct_gst_player_clear_latency_profile(RctGstPlayer *self) {
+    GPtrArray *probes = NULL;
+    guint i = 0;
+
+    if (self->latency_element_added_handler) {
+        g_signal_handler_disconnect(self->pipeline, self->latency_element_added_handler);
+        self->latency_element_added_handler = 0;
+    }
+
+    g_mutex_lock(&self->stats_lock);
+
+    self->latency_generation++;
+    probes = self->latency_probes;
+    self->latency_probes = g_ptr_array_new();
+
+    g_mutex_unlock(&self->stats_lock);
+
+    for (i = 0; i < probes->len; i++) {
+        RctGstPadProbe *probe = g_ptr_array_index(probes, i);
+
+        gst_pad_remove_probe(probe->pad, probe->probe_id);
+        gst_object_unref(probe->pad);
+        g_free(probe);
+    }
+
+    g_ptr_array_unref(probes);
+}
+
+gboolean rct_gst_player_query_latency(RctGstPlayer *self,
+                                      gboolean *live,
+                                      GstClockTime *min_latency,
+                                      GstClockTime *max_latency) {
+    GstPipeline *pipeline = NULL;
+    GstQuery *query = NULL;
+    gboolean answered = FALSE;
+
+    g_mutex_lock(&self->stats_lock);
+    if (self->pipeline)
+        pipeline = gst_object_ref(self->pipeline);
+    g_mutex_unlock(&self->stats_lock);
+
+    if (pipeline == NULL)
+        return FALSE;
+
+    query = gst_query_new_latency();
+    answered = gst_element_query(GST_ELEMENT(pipeline), query);
+    if (answered)
+        gst_query_parse_latency(query, live, min_latency, max_latency);
+
+    gst_query_unref(query);
+    gst_object_unref(pipeline);
+
+    return answered;
+}
+
+// Memory budget
+// Queues only : buffer pools are sized by the allocation queries of the elements sharing them
+#define RCT_GST_MEMORY_BUDGET_INTERVAL 250 // Milliseconds
+#define RCT_GST_MEMORY_BUDGET_WARNING 90   // Percent of the budget reported, before it's reached
+#define RCT_GST_MEMORY_BUDGET_REARM 75
+
+static gboolean rct_gst_element_is_budget_queue(GstElement *element) {
+    // Frame tap branches are leaky already
+    if (g_str_has_prefix(GST_ELEMENT_NAME(element), "rct_gst_tap_"))
+        return FALSE;
+
+    return rct_gst_element_is_queue(element);
+}
+
+// Called with stats_lock held
+static void rct_gst_player_add_budget_queue(RctGstPlayer *self, GstElement *element) {
+    guint i = 0;
+
+    for (i = 0; i < self->budget_queues->len; i++) {
+        if (g_ptr_array_index(self->budget_queues, i) == element)
+            return;
+    }
+
+    g_ptr_array_add(self->budget_queues, gst_object_ref(element));
+}
+
+// Even shares, a multiqueue splitting its own between its queues. Limits are only ever lowered :
+// elements raising them again (decodebin on overruns) are brought back by the next check.
+// A queue still takes one buffer past its limit. Returns the bytes held by the queues.
+static guint64 rct_gst_player_enforce_memory_budget(RctGstPlayer *self) {
+    GPtrArray *queues = NULL;
+    guint64 budget = 0;
+    guint64 buffered_bytes = 0;
+    guint i = 0;
+
+    queues = g_ptr_array_new_with_free_func(gst_object_unref);
+
+    g_mutex_lock(&self->stats_lock);
+    budget = self->pipeline_memory_budget;
+    for (i = 0; i < self->budget_queues->len; i++)
+        g_ptr_array_add(queues, gst_object_ref(g_ptr_array_index(self->budget_queues, i)));
+    g_mutex_unlock(&self->stats_lock);
+
+    for (i = 0; budget > 0 && i < queues->len; i++) {
+        GstElement *queue = g_ptr_array_index(queues, i);
+        RctGstQueueStats levels = {0};
+        guint n_queues = 0;
+        guint max_size_bytes = 0;
+        guint limit = 0;
+
+        n_queues = rct_gst_queue_get_levels(queue, &levels);
+
+        // 0 would lift the limit
+        limit = (guint) CLAMP(budget / queues->len / n_queues, 1, G_MAXUINT);
+
+        g_object_get(queue, "max-size-bytes", &max_size_bytes, NULL);
+        if (max_size_bytes == 0 || max_size_bytes > limit)
+            g_object_set(queue, "max-size-bytes", limit, NULL);
+
+        buffered_bytes += levels.bytes;
+    }
+
+    g_ptr_array_unref(queues);
+
+    return buffered_bytes;
+}
+
+static void cb_collect_budget_queue(const GValue *item, gpointer user_data) {
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+    GstElement *element = GST_ELEMENT(g_value_get_object(item));
+
+    if (!rct_gst_element_is_budget_queue(element))
+        return;
+
+    g_mutex_lock(&self->stats_lock);
+    rct_gst_player_add_budget_queue(self, element);
+    g_mutex_unlock(&self->stats_lock);
+}
+
+// Queues created later on (decodebin, playbin...) are sized before getting any data
+static void cb_budget_element_added(GstBin *bin, GstBin *sub_bin, GstElement *element, gpointer user_data) {
+    (void) sub_bin;
+
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+    gboolean current = FALSE;
+
+    if (!rct_gst_element_is_budget_queue(element))
+        return;
+
+    g_mutex_lock(&self->stats_lock);
+    current = GST_ELEMENT(bin) == GST_ELEMENT(self->pipeline);
+    if (current)
+        rct_gst_player_add_budget_queue(self, element);
+    g_mutex_unlock(&self->stats_lock);
+
+    if (current)
+        rct_gst_player_enforce_memory_budget(self);
+}
+
+static gboolean cb_check_memory_budget(gpointer data) {
+    RctGstPlayer *self = NULL;
+    guint64 budget = 0;
+    guint64 buffered_bytes = 0;
+    gboolean report = FALSE;
+    guint i = 0;
+
+    self = (RctGstPlayer *) data;
+
+    // Removed queues leave their share to the others
+    g_mutex_lock(&self->stats_lock);
+    for (i = self->budget_queues->len; i > 0; i--) {
+        GstObject *queue = g_ptr_array_index(self->budget_queues, i - 1);
+
+        if (self->pipeline == NULL || !gst_object_has_as_ancestor(queue, GST_OBJECT(self->pipeline)))
+            g_ptr_array_remove_index_fast(self->budget_queues, i - 1);
+    }
+    g_mutex_unlock(&self->stats_lock);
+
+    buffered_bytes = rct_gst_player_enforce_memory_budget(self);
+
+    g_mutex_lock(&self->stats_lock);
+
+    budget = self->pipeline_memory_budget;
+    self->max_buffered_bytes = MAX(self->max_buffered_bytes, buffered_bytes);
+
+    // Reported once, until the queues drain again
+    if (!self->over_budget && buffered_bytes >= budget / 100 * RCT_GST_MEMORY_BUDGET_WARNING) {
+        self->over_budget = TRUE;
+        report = TRUE;
+    } else if (self->over_budget && buffered_bytes < budget / 100 * RCT_GST_MEMORY_BUDGET_REARM) {
+        self->over_budget = FALSE;
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (!report)
+        return G_SOURCE_CONTINUE;
+
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_MEMORY_BUDGET, NULL, buffered_bytes,
+                  buffered_bytes > budget ? "over budget" : "close to budget");
+
+    if (self->on_rct_gst_memory_budget) {
+        gint64 start_time = g_get_monotonic_time();
+
+        self->on_rct_gst_memory_budget(self, buffered_bytes, budget);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_MEMORY_BUDGET, start_time);
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+static void rct_gst_player_schedule_memory_budget(RctGstPlayer *self) {
+    rct_gst_player_clear_source(&self->budget_source);
+
+    if (self->context && self->pipeline_memory_budget > 0)
+        self->budget_source = rct_gst_player_attach_source(self,
+                                                           g_timeout_source_new(RCT_GST_MEMORY_BUDGET_INTERVAL),
+                                                           cb_check_memory_budget,
+                                                           self);
+}
+
+// Called once the new pipeline is current, after the latency profile which lifts byte limits
+static void rct_gst_player_apply_memory_budget(RctGstPlayer *self) {
+    GstIterator *iterator = NULL;
+
+    if (self->memory_budget == 0 || self->pipeline == NULL)
+        return;
+
+    g_mutex_lock(&self->stats_lock);
+    self->pipeline_memory_budget = self->memory_budget;
+    self->max_buffered_bytes = 0;
+    self->over_budget = FALSE;
+    g_mutex_unlock(&self->stats_lock);
+
+    self->budget_element_added_handler = g_signal_connect(self->pipeline, "deep-element-added",
+                                                          G_CALLBACK(cb_budget_element_added),
+                                                          self);
+
+    iterator = gst_bin_iterate_recurse(GST_BIN(self->pipeline));
+    gst_iterator_foreach(iterator, cb_collect_budget_queue, self);
+    gst_iterator_free(iterator);
+
+    rct_gst_player_enforce_memory_budget(self);
+    rct_gst_player_schedule_memory_budget(self);
+}
+
+// Queues keep their limits : a cached pipeline is sized already
+static void rct_gst_player_clear_memory_budget(RctGstPlayer *self) {
+    GPtrArray *queues = NULL;
+
+    if (self->budget_element_added_handler) {
+        g_signal_handler_disconnect(self->pipeline, self->budget_element_added_handler);
+        self->budget_element_added_handler = 0;
+    }
+
+    rct_gst_player_clear_source(&self->budget_source);
+
+    g_mutex_lock(&self->stats_lock);
+
+    self->pipeline_memory_budget = 0;
+    queues = self->budget_queues;
+    self->budget_queues = g_ptr_array_new_with_free_func(gst_object_unref);
+
+    g_mutex_unlock(&self->stats_lock);
+
+    g_ptr_array_unref(queues);
+}
+
+// Playlist
+// URIs are played by playbin, anything else is a launch string
+static gboolean rct_gst_playlist_item_is_uri(const gchar *item) {
+    return gst_uri_is_valid(item);
+}
+
+static gchar *rct_gst_playlist_item_get_launch(const gchar *item) {
+    if (rct_gst_playlist_item_is_uri(item))
+        return g_strdup_printf("playbin uri=\"%s\"", item);
+
+    return g_strdup(item);
+}
+
+// Called with stats_lock held, -1 past the end
+static gint rct_gst_player_get_playlist_next(RctGstPlayer *self, gint index) {
+    if (index + 1 < (gint) self->playlist->len)
+        return index + 1;
+
+    return self->playlist_loop && self->playlist->len > 0 ? 0 : -1;
+}
+
+// A buffer reached a sink of the preloaded pipeline : its first frame is ready to be rendered
+static GstPadProbeReturn cb_preloaded_buffer(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void) pad;
+    (void) info;
+
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+
+    g_mutex_lock(&self->stats_lock);
+    self->playlist_prerolled = TRUE;
+    g_mutex_unlock(&self->stats_lock);
+
+    return GST_PAD_PROBE_OK;
+}
+
+// Bound to the surface and probed before prerolling, without rendering over the current item
+static void rct_gst_player_prepare_preloaded_sink(RctGstPlayer *self, GstElement *sink) {
+    GstPad *pad = NULL;
+
+    if (GST_IS_BIN(sink) || g_str_has_prefix(GST_ELEMENT_NAME(sink), "rct_gst_tap_"))
+        return;
+
+    if (g_object_class_find_property(G_OBJECT_GET_CLASS(sink), "show-preroll-frame")) {
+        g_object_set(sink, "show-preroll-frame", FALSE, NULL);
+        g_object_set_data(G_OBJECT(sink), RCT_GST_PREROLL_HIDDEN_KEY, GINT_TO_POINTER(TRUE));
+    }
+
+    if (self->drawable_surface && GST_IS_VIDEO_OVERLAY(sink))
+        gst_video_overlay_set_window_handle(GST_VIDEO_OVERLAY(sink), (guintptr) self->drawable_surface);
+
+    pad = gst_element_get_static_pad(sink, "sink");
+    if (pad == NULL)
+        return;
+
+    g_mutex_lock(&self->stats_lock);
+
+    if (self->preloaded_probe == NULL) {
+        self->preloaded_probe = g_malloc0(sizeof(RctGstPadProbe));
+        self->preloaded_probe->pad = gst_object_ref(pad);
+        self->preloaded_probe->probe_id = gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER,
+                                                            cb_preloaded_buffer, self, NULL);
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+
+    gst_object_unref(pad);
+}
+
+static void cb_prepare_preloaded_sink(const GValue *item, gpointer user_data) {
+    GstElement *element = GST_ELEMENT(g_value_get_object(item));
+
+    if (GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK))
+        rct_gst_player_prepare_preloaded_sink((RctGstPlayer *) user_data, element);
+}
+
+// Sinks of playbin are created while prerolling
+static void cb_preloaded_element_added(GstBin *bin, GstBin *sub_bin, GstElement *element, gpointer user_data) {
+    (void) sub_bin;
+
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+    gboolean preloaded = FALSE;
+
+    g_mutex_lock(&self->stats_lock);
+    preloaded = GST_ELEMENT(bin) == GST_ELEMENT(self->preloaded_pipeline);
+    g_mutex_unlock(&self->stats_lock);
+
+    if (preloaded && GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK))
+        rct_gst_player_prepare_preloaded_sink(self, element);
+}
+
+static void cb_show_preroll_frame(const GValue *item, gpointer user_data) {
+    (void) user_data;
+
+    GstElement *element = GST_ELEMENT(g_value_get_object(item));
+
+    if (g_object_get_data(G_OBJECT(element), RCT_GST_PREROLL_HIDDEN_KEY) == NULL)
+        return;
+
+    g_object_set_data(G_OBJECT(element), RCT_GST_PREROLL_HIDDEN_KEY, NULL);
+    g_object_set(element, "show-preroll-frame", TRUE, NULL);
+}
+
+static void rct_gst_player_unwatch_preloaded_pipeline(RctGstPlayer *self) {
+    RctGstPadProbe *probe = NULL;
+
+    if (self->preloaded_element_added_handler) {
+        g_signal_handler_disconnect(self->preloaded_pipeline, self->preloaded_element_added_handler);
+        self->preloaded_element_added_handler = 0;
+    }
+
+    g_mutex_lock(&self->stats_lock);
+    probe = self->preloaded_probe;
+    self->preloaded_probe = NULL;
+    g_mutex_unlock(&self->stats_lock);
+
+    if (probe) {
+        gst_pad_remove_probe(probe->pad, probe->probe_id);
+        gst_object_unref(probe->pad);
+        g_free(probe);
+    }
+}
+
+static void rct_gst_player_clear_preloaded_pipeline(RctGstPlayer *self) {
+    GstPipeline *pipeline = NULL;
+
+    rct_gst_player_unwatch_preloaded_pipeline(self);
+
+    g_mutex_lock(&self->stats_lock);
+    pipeline = self->preloaded_pipeline;
+    self->preloaded_pipeline = NULL;
+    self->playlist_prerolled = FALSE;
+    g_mutex_unlock(&self->stats_lock);
+
+    if (pipeline)
+        rct_gst_player_destroy_pipeline(self, pipeline);
+
+    g_free(self->preloaded_launch);
+    self->preloaded_launch = NULL;
+}
+
+// Whether it prerolled is kept for rct_gst_player_watch_playlist
+static GstPipeline *rct_gst_player_take_preloaded_pipeline(RctGstPlayer *self,
+                                                           const gchar *parse_launch_pipeline) {
+    GstPipeline *pipeline = NULL;
+    GstIterator *iterator = NULL;
+
+    if (self->preloaded_pipeline == NULL ||
+        g_strcmp0(self->preloaded_launch, parse_launch_pipeline) != 0)
+        return NULL;
+
+    rct_gst_player_unwatch_preloaded_pipeline(self);
+
+    g_mutex_lock(&self->stats_lock);
+    pipeline = self->preloaded_pipeline;
+    self->preloaded_pipeline = NULL;
+    g_mutex_unlock(&self->stats_lock);
+
+    // The prerolled frame is rendered once playing
+    iterator = gst_bin_iterate_recurse(GST_BIN(pipeline));
+    gst_iterator_foreach(iterator, cb_show_preroll_frame, NULL);
+    gst_iterator_free(iterator);
+
+    g_free(self->preloaded_launch);
+    self->preloaded_launch = NULL;
+
+    return pipeline;
+}
+
+// The next item is built and prerolled while the current one plays, unless playbin switches to it
+static void rct_gst_player_preload_playlist(RctGstPlayer *self) {
+    gchar *item = NULL;
+    gchar *launch = NULL;
+    GstPipeline *pipeline = NULL;
+    GstIterator *iterator = NULL;
+    gint next = -1;
+
+    g_mutex_lock(&self->stats_lock);
+    if (self->playlist_index >= 0)
+        next = rct_gst_player_get_playlist_next(self, self->playlist_index);
+    if (next >= 0)
+        item = g_strdup(g_ptr_array_index(self->playlist, next));
+    g_mutex_unlock(&self->stats_lock);
+
+    if (item == NULL || (rct_gst_playlist_item_is_uri(item) && self->about_to_finish_handler)) {
+        rct_gst_player_clear_preloaded_pipeline(self);
+        goto out;
+    }
+
+    launch = rct_gst_playlist_item_get_launch(item);
+    if (g_strcmp0(launch, self->preloaded_launch) == 0)
+        goto out;
+
+    rct_gst_player_clear_preloaded_pipeline(self);
+
+    pipeline = GST_PIPELINE(gst_parse_launch(launch, NULL));
+    if (pipeline == NULL)
+        goto out;
+
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PLAYLIST_PRELOADED, NULL, next, launch);
+
+    g_mutex_lock(&self->stats_lock);
+    self->preloaded_pipeline = pipeline;
+    g_mutex_unlock(&self->stats_lock);
+
+    // Its messages are dropped, so sinks are prepared here instead of on prepare-window-handle
+    self->preloaded_element_added_handler = g_signal_connect(pipeline, "deep-element-added",
+                                                             G_CALLBACK(cb_preloaded_element_added),
+                                                             self);
+
+    iterator = gst_bin_iterate_recurse(GST_BIN(pipeline));
+    gst_iterator_foreach(iterator, cb_prepare_preloaded_sink, self);
+    gst_iterator_free(iterator);
+
+    // Nobody is listening until it's current, like cached pipelines
+    rct_gst_player_detach_bus(pipeline);
+    gst_element_set_state(GST_ELEMENT(pipeline), GST_STATE_PAUSED);
+
+    self->preloaded_launch = launch;
+    launch = NULL;
+
+out:
+    g_free(launch);
+    g_free(item);
+}
+
+static void rct_gst_player_play_playlist_item(RctGstPlayer *self, gint index) {
+    gchar *launch = NULL;
+
+    RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PLAYLIST_ITEM, NULL, index, NULL);
+
+    g_mutex_lock(&self->stats_lock);
+    self->playlist_index = index;
+    self->playlist_next = -1;
+    launch = rct_gst_playlist_item_get_launch(g_ptr_array_index(self->playlist, index));
+    g_mutex_unlock(&self->stats_lock);
+
+    rct_gst_player_set_parse_launch_pipeline(self, launch);
+    rct_gst_player_preload_playlist(self);
+}
+
+// On EOS : FALSE once the playlist is over, or when there is none
+static gboolean rct_gst_player_advance_playlist(RctGstPlayer *self) {
+    gint next = -1;
+
+    g_mutex_lock(&self->stats_lock);
+    if (self->playlist_index >= 0) {
+        next = rct_gst_player_get_playlist_next(self, self->playlist_index);
+        if (next < 0)
+            self->playlist_index = -1;
+    }
+    g_mutex_unlock(&self->stats_lock);
+
+    if (next < 0) {
+        rct_gst_player_clear_preloaded_pipeline(self);
+        return FALSE;
+    }
+
+    rct_gst_player_play_playlist_item(self, next);
+    return TRUE;
+}
+
+// Streaming thread : the next URI has to be set before returning for the switch to be gapless
+static void cb_about_to_finish(GstElement *playbin, gpointer user_data) {
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+    gchar *uri = NULL;
+    gint next = -1;
+
+    g_mutex_lock(&self->stats_lock);
+
+    if (playbin == GST_ELEMENT(self->pipeline) && self->playlist_index >= 0) {
+        next = rct_gst_player_get_playlist_next(self, self->playlist_next >= 0 ?
+                                                      self->playlist_next : self->playlist_index);
+
+        // Launch strings wait for the EOS and their preloaded pipeline
+        if (next >= 0 && rct_gst_playlist_item_is_uri(g_ptr_array_index(self->playlist, next))) {
+            uri = g_strdup(g_ptr_array_index(self->playlist, next));
+            self->playlist_next = next;
+        }
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (uri)
+        g_object_set(playbin, "uri", uri, NULL);
+
+    g_free(uri);
+}
+
+static gboolean cb_report_playlist_item(gpointer data) {
+    RctGstPlayer *self = (RctGstPlayer *) data;
+    gint index = -1;
+    gint64 gap = -1;
+    gboolean switched = FALSE;
+    gint64 start_time = 0;
+
+    g_mutex_lock(&self->stats_lock);
+
+    if (self->playlist_next >= 0) {
+        self->playlist_index = self->playlist_next;
+        self->playlist_next = -1;
+        switched = TRUE;
+    }
+
+    index = self->playlist_index;
+    gap = self->playlist_gap;
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (index < 0)
+        return G_SOURCE_REMOVE;
+
+    if (switched) {
+        RCT_GST_TRACE(self, RCT_GST_TRACE_LEVEL_INFO, RCT_GST_TRACE_PLAYLIST_ITEM, NULL, index, NULL);
+        rct_gst_player_preload_playlist(self);
+    }
+
+    if (self->on_rct_gst_playlist_item) {
+        start_time = g_get_monotonic_time();
+        self->on_rct_gst_playlist_item(self, (guint) index, gap);
+        rct_gst_player_account_callback(self, RCT_GST_CALLBACK_PLAYLIST_ITEM, start_time);
+    }
+
+    return G_SOURCE_REMOVE;
+}
+
+// The gap is between the last buffer of an item and the first one of the next, reaching the sink
+static GstPadProbeReturn cb_measure_gap(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+    (void) pad;
+
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+    gint64 now = 0;
+    gboolean report = FALSE;
+
+    if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM) {
+        if (GST_EVENT_TYPE(GST_PAD_PROBE_INFO_EVENT(info)) == GST_EVENT_STREAM_START) {
+            g_mutex_lock(&self->stats_lock);
+            self->playlist_boundary = TRUE;
+            g_mutex_unlock(&self->stats_lock);
+        }
+
+        return GST_PAD_PROBE_OK;
+    }
+
+    now = g_get_monotonic_time();
+
+    g_mutex_lock(&self->stats_lock);
+
+    if (self->playlist_boundary) {
+        self->playlist_boundary = FALSE;
+        self->playlist_gap = self->playlist_last_buffer >= 0 ? now - self->playlist_last_buffer : -1;
+        report = TRUE;
+    }
+
+    self->playlist_last_buffer = now;
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (report && self->context)
+        g_main_context_invoke_full(self->context, G_PRIORITY_DEFAULT, cb_report_playlist_item,
+                                   g_object_ref(self), g_object_unref);
+
+    return GST_PAD_PROBE_OK;
+}
+
+// A single sink is probed, so that audio and video don't both report the same switch
+static void rct_gst_player_watch_playlist_sink(RctGstPlayer *self, GstElement *sink) {
+    RctGstPadProbe *probe = NULL;
+    RctGstPadProbe *replaced = NULL;
+    const gchar *klass = NULL;
+    gboolean video = FALSE;
+    GstPad *pad = NULL;
+
+    if (GST_IS_BIN(sink) || g_str_has_prefix(GST_ELEMENT_NAME(sink), "rct_gst_tap_"))
+        return;
+
+    klass = gst_element_class_get_metadata(GST_ELEMENT_GET_CLASS(sink), GST_ELEMENT_METADATA_KLASS);
+    video = klass && strstr(klass, "Video") != NULL;
+
+    pad = gst_element_get_static_pad(sink, "sink");
+    if (pad == NULL)
+        return;
+
+    g_mutex_lock(&self->stats_lock);
+
+    if (self->playlist_probe == NULL || (video && !self->playlist_probe_video)) {
+        replaced = self->playlist_probe;
+
+        probe = g_malloc0(sizeof(RctGstPadProbe));
+        probe->pad = gst_object_ref(pad);
+        probe->probe_id = gst_pad_add_probe(pad,
+                                            GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+                                            cb_measure_gap, self, NULL);
+
+        self->playlist_probe = probe;
+        self->playlist_probe_video = video;
+    }
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (replaced) {
+        gst_pad_remove_probe(replaced->pad, replaced->probe_id);
+        gst_object_unref(replaced->pad);
+        g_free(replaced);
+    }
+
+    gst_object_unref(pad);
+}
+
+static void cb_watch_playlist_sink(const GValue *item, gpointer user_data) {
+    GstElement *element = GST_ELEMENT(g_value_get_object(item));
+
+    if (GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK))
+        rct_gst_player_watch_playlist_sink((RctGstPlayer *) user_data, element);
+}
+
+// Sinks of playbin are created while prerolling
+static void cb_playlist_element_added(GstBin *bin, GstBin *sub_bin, GstElement *element, gpointer user_data) {
+    (void) sub_bin;
+
+    RctGstPlayer *self = (RctGstPlayer *) user_data;
+    gboolean current = FALSE;
+
+    g_mutex_lock(&self->stats_lock);
+    current = GST_ELEMENT(bin) == GST_ELEMENT(self->pipeline);
+    g_mutex_unlock(&self->stats_lock);
+
+    if (current && GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK))
+        rct_gst_player_watch_playlist_sink(self, element);
+}
+
+// Called once the new pipeline is current, while an item of the playlist is playing
+static void rct_gst_player_watch_playlist(RctGstPlayer *self) {
+    GstIterator *iterator = NULL;
+    gboolean playing = FALSE;
+    gboolean report = FALSE;
+    gint64 now = g_get_monotonic_time();
+
+    g_mutex_lock(&self->stats_lock);
+
+    playing = self->playlist_index >= 0;
+
+    // The first buffer of a prerolled pipeline went through its sink already, and is rendered now
+    if (playing && self->playlist_prerolled) {
+        self->playlist_boundary = FALSE;
+        self->playlist_gap = self->playlist_last_buffer >= 0 ? now - self->playlist_last_buffer : -1;
+        self->playlist_last_buffer = now;
+        report = TRUE;
+    } else {
+        // Prerolled pipelines went through their stream start already
+        self->playlist_boundary = TRUE;
+    }
+
+    self->playlist_prerolled = FALSE;
+
+    g_mutex_unlock(&self->stats_lock);
+
+    if (report && self->context)
+        g_main_context_invoke_full(self->context, G_PRIORITY_DEFAULT, cb_report_playlist_item,
+                                   g_object_ref(self), g_object_unref);
+
+    if (!playing || self->pipeline == NULL)
+        return;
+
+    if (g_signal_lookup("about-to-finish", G_OBJECT_TYPE(self->pipeline)))
+        self->about_to_finish_handler = g_signal_connect(self->pipeline, "about-to-finish",
+                                                         G_CALLBACK(cb_about_to_finish), self);
+
+    self->playlist_element_added_handler = g_signal_connect(self->pipeline, "deep-element-added",
+                                                            G_CALLBACK(cb_playlist_element_added),
+                                                            self);
+
+    iterator = gst_bin_iterate_recurse(GST_BIN(self->pipeline));
+    gst_iterator_foreach(iterator, cb_watch_playlist_sink, self);
+    gst_iterator_free(iterator);
+}
+
+static void rct_gst_player_unwatch_playlist(RctGstPlayer *self) {
+    RctGstPadProbe *probe = NULL;
+
+    if (self->about_to_finish_handler) {
+        g_signal_handler_disconnect(self->pipeline, self->about_to_finish_handler);
+        self->about_to_finish_handler = 0;
+    }
+
+    if (self->playlist_element_added_handler) {
+        g_signal_handler_disconnect(self->pipeline, self->playlist_element_added_handler);
+        self->playlist_element_added_handler = 0;
+    }
+
+    g_mutex_lock(&self->stats_lock);
+    probe = self->playlist_probe;
+    self->playlist_probe = NULL;
+    self->playlist_probe_video = FALSE;
+    g_mutex_unlock(&self->stats_lock);
+
+    if (probe) {
+        gst_pad_remove_probe(probe->pad, probe->probe_id);
+        gst_object_unref(probe->pad);
+        g_free(probe);
+    }
+}
+
+// Starts with the new item when none is playing, the playlist being over or empty
+static void rct_gst_player_apply_playlist_enqueue(RctGstPlayer *self, gchar *item) {
+    gint index = -1;
+
+    g_mutex_lock(&self->stats_lock);
+    g_ptr_array_add(self->playlist, item);
+    if (self->playlist_index < 0) {
+        index = (gint) self->playlist->len - 1;
+        self->playlist_last_buffer = -1;
+    }
+    g_mutex_unlock(&self->stats_lock);
+
+    if (index >= 0)
+        rct_gst_player_play_playlist_item(self, index);
+    else
+        rct_gst_player_preload_playlist(self);
+}
+
+static void rct_gst_player_apply_playlist_skip(RctGstPlayer *self) {
+    gint next = -1;
+
+    g_mutex_lock(&self->stats_lock);
+    if (self->playlist_index >= 0)
+        next = rct_gst_player_get_playlist_next(self, self->playlist_next >= 0 ?
+                                                      self->playlist_next : self->playlist_index);
+    else if (self->playlist->len > 0) {
+        next = 0;
+        self->playlist_last_buffer = -1;
+    }
+    g_mutex_unlock(&self->stats_lock);
+
+    if (next >= 0)
+        rct_gst_player_play_playlist_item(self, next);
+}
+
+// The current pipeline keeps playing, without switching to the next item
+static void rct_gst_player_leave_playlist(RctGstPlayer *self) {
+    g_mutex_lock(&self->stats_lock);
+    self->playlist_index = -1;
+    self->playlist_next = -1;
+    g_mutex_unlock(&self->stats_lock);
+
+    rct_gst_player_clear_preloaded_pipeline(self);
+}
+
+static void rct_gst_player_apply_playlist_clear(RctGstPlayer *self) {
+    rct_gst_player_leave_playlist(self);
+
+    g_mutex_lock(&self->stats_lock);
+    g_ptr_array_set_size(self->playlist, 0);
+    g_mutex_unlock(&self->stats_lock);
+}
+
+// Position updates
+static gboolean cb_update_position(gpointer data) {
+    RctGstPlayer *self = NULL;
+    gint64 position = -1;
+    gint64 duration = -1;
+    gint64 start_time = 0;
+
+    self = (RctGstPlayer *) data;
+
+    if (self->pipeline == NULL || self->on_rct_gst_pipeline_position == NULL)
+        return G_SOURCE_CONTINUE;
+
+    if (!gst_element_query_position(GST_ELEMENT(self->pipeline), GST_FORMAT_TIME, &position))
+        position = -1;
+
+    if (!gst_element_query_duration(GST_ELEMENT(self->pipeline), GST_FORMAT_TIME, &duration))
+        duration = -1;
+
+    // Positions which barely moved aren't worth crossing to the bindings
+    if (duration == self->last_duration &&
+        (position == self->last_position ||
+         (position >= 0 && self->last_position >= 0 &&
+          ABS(position - self->last_position) < (gint64) self->position_update_threshold * GST_MSECOND)))
+        return G_SOURCE_CONTINUE;
+
+    self->last_position = position;
+    self->last_duration = duration;
+
+    start_time = g_get_monotonic_time();
+    self->on_rct_gst_pipeline_position(self, position, duration);
+    rct_gst_player_account_callback(self, RCT_GST_CALLBACK_POSITION, start_time);
+
+    return G_SOURCE_CONTINUE;
+}
+
+// Ticks only while the pipeline is playing
+static void rct_gst_player_schedule_position_updates(RctGstPlayer *self) {
+    GstState state = GST_STATE_VOID_PENDING;
+
+    rct_gst_player_clear_source(&self->position_source);
+
+    if (self->pipeline)
+        gst_element_get_state(GST_ELEMENT(self->pipeline), &state, NULL, 0);
+
+    if (self->context && self->position_update_interval > 0 && state == GST_STATE_PLAYING)
+        self->position_source = rct_gst_player_attach_source(self,
+                                                             g_timeout_source_new(self->position_update_interval),
+                                                             cb_update_position,
+                                                             self);
+}
+
+// The next tick reports the position whatever it is
+static void rct_gst_player_reset_position(RctGstPlayer *self) {
+    self->last_position = -1;
+    self->last_duration = -1;
+}
+
+static void rct_gst_player_apply_position_update_interval(RctGstPlayer *self,
+                                                          guint position_update_interval) {
+    self->position_update_interval = position_update_interval;
+    rct_gst_player_schedule_position_updates(self);
+}
+
+// Snapshots
+// Decoding, scaling and encoding happen on a worker, results are delivered on the player context
+// while it runs
+static void rct_gst_snapshot_job_free(RctGstSnapshotJob *job) {
+    if (job->sample)
+        gst_sample_unref(job->sample);
+
+    if (job->image)
+        gst_sample_unref(job->image);
+
+    g_ptr_array_unref(job->thumbnails);
+    g_array_unref(job->positions);
+    g_free(job->uri);
+    g_object_unref(job->self);
+    g_free(job);
+}
+
+static gboolean cb_deliver_snapshot(gpointer data) {
+    RctGstSnapshotJob *job = (RctGstSnapshotJob *) data;
+    RctGstThumbnail *thumbnails = NULL;
+    GstMapInfo *maps = NULL;
+    GstMapInfo map_info = GST_MAP_INFO_INIT;
+    GstBuffer *buffer = NULL;
+    gint64 start_time = 0;
+    guint n_thumbnails = 0;
+    guint i = 0;
+
+    start_time = g_get_monotonic_time();
+    job->delivered = TRUE;
+
+    if (job->uri == NULL) {
+        buffer = job->image ? gst_sample_get_buffer(job->image) : NULL;
+
+        if (buffer && gst_buffer_map(buffer, &map_info, GST_MAP_READ)) {
+            job->snapshot_callback(job->self, map_info.data, map_info.size, job->user_data);
+            gst_buffer_unmap(buffer, &map_info);
+        } else {
+            job->snapshot_callback(job->self, NULL, 0, job->user_data);
+        }
+    } else {
+        thumbnails = g_new0(RctGstThumbnail, MAX(job->thumbnails->len, 1));
+        maps = g_new0(GstMapInfo, MAX(job->thumbnails->len, 1));
+
+        for (i = 0; i < job->thumbnails->len; i++) {
+            GstSample *image = g_ptr_array_index(job->thumbnails, i);
+
+            buffer = gst_sample_get_buffer(image);
+            if (!gst_buffer_map(buffer, &maps[n_thumbnails], GST_MAP_READ))
+                continue;
+
+            thumbnails[n_thumbnails].position = g_array_index(job->positions, GstClockTime, i);
+            thumbnails[n_thumbnails].data = maps[n_thumbnails].data;
+            thumbnails[n_thumbnails].size = maps[n_thumbnails].size;
+            n_thumbnails++;
+        }
+
+        job->thumbnails_callback(job->self, thumbnails, n_thumbnails, job->user_data);
+
+        for (i = 0; i < n_thumbnails; i++)
+            gst_buffer_unmap(gst_sample_get_buffer(g_ptr_array_index(job->thumbnails, i)), &maps[i]);
+
+        g_free(maps);
+        g_free(thumbnails);
+    }
+
+    rct_gst_player_account_callback(job->self, RCT_GST_CALLBACK_SNAPSHOT, start_time);
+
+    return G_SOURCE_REMOVE;
+}
+
+// Destroy notify of the delivery : the player stopped before it was dispatched, the caller still
+// gets its callback
+static void cb_complete_snapshot(gpointer data) {
+    RctGstSnapshotJob *job = (RctGstSnapshotJob *) data;
+
+    if (!job->delivered)
+        cb_deliver_snapshot(job);
+
+    g_mutex_lock(&job->self->stats_lock);
+    g_ptr_array_remove_fast(job->self->snapshot_sources, job->source);
+    g_mutex_unlock(&job->self->stats_lock);
+
+    rct_gst_snapshot_job_free(job);
+}
+
+// Once the loop quit : its context isn't dispatched anymore
+static void rct_gst_player_flush_snapshots(RctGstPlayer *self) {
+    GPtrArray *sources = NULL;
+    guint i = 0;
+
+    g_mutex_lock(&self->stats_lock);
+    sources = self->snapshot_sources;
+    self->snapshot_sources = g_ptr_array_new_with_free_func((GDestroyNotify) g_source_unref);
+    g_mutex_unlock(&self->stats_lock);
+
+    for (i = 0; i < sources->len; i++)
+        g_source_destroy(g_ptr_array_index(sources, i));
+
+    g_ptr_array_unref(sources);
+}
+
+// Missing dimensions follow the display aspect ratio of the sample
+static GstCaps *rct_gst_snapshot_get_caps(GstSample *sample,
+                                          RctGstSnapshotFormat format,
+                                          gint width,
+                                          gint height) {
+    GstVideoInfo video_info;
+    GstCaps *caps = NULL;
+    gint display_width = 0;
+
+    caps = gst_caps_new_simple(format == RCT_GST_SNAPSHOT_JPEG ? "image/jpeg" : "image/png",
+                               "pixel-aspect-ratio", GST_TYPE_FRACTION, 1, 1,
+                               NULL);
+
+    if (!gst_video_info_from_caps(&video_info, gst_sample_get_caps(sample)) ||
+        video_info.height == 0 || video_info.par_d == 0)
+        return caps;
+
+    display_width = (gint) gst_util_uint64_scale_int(video_info.width, video_info.par_n, video_info.par_d);
+
+    if (width <= 0 && height <= 0) {
+        width = display_width;
+        height = video_info.height;
+    } else if (width <= 0) {
+        width = (gint) gst_util_uint64_scale_int(height, display_width, video_info.height);
+    } else if (height <= 0 && display_width > 0) {
+        height = (gint) gst_util_uint64_scale_int(width, video_info.height, display_width);
+    }
+
+    if (width > 0 && height > 0)
+        gst_caps_set_simple(caps, "width", G_TYPE_INT, width, "height", G_TYPE_INT, height, NULL);
+
+    return caps;
+}
+
+static GstSample *rct_gst_snapshot_job_encode(RctGstSnapshotJob *job, GstSample *sample) {
+    GstSample *image = NULL;
+    GstCaps *caps = NULL;
+    GError *error = NULL;
+
+    caps = rct_gst_snapshot_get_caps(sample, job->format, job->width, job->height);
+    image = gst_video_convert_sample(sample, caps, RCT_GST_SNAPSHOT_TIMEOUT, &error);
+
+    if (error) {
+        RCT_GST_TRACE(job->self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_SNAPSHOT_FAILED, NULL, 0,
+                      error->message);
+        g_error_free(error);
+    }
+
+    gst_caps_unref(caps);
+
+    return image;
+}
+
+static gboolean rct_gst_snapshot_wait_preroll(GstBus *bus) {
+    GstMessage *message = NULL;
+    gboolean prerolled = FALSE;
+
+    message = gst_bus_timed_pop_filtered(bus, RCT_GST_SNAPSHOT_TIMEOUT,
+                                         GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+
+    if (message) {
+        prerolled = GST_MESSAGE_TYPE(message) == GST_MESSAGE_ASYNC_DONE;
+        gst_message_unref(message);
+    }
+
+    return prerolled;
+}
+
+// Video only, each seek snapping to a key unit : only key frames get decoded
+static void rct_gst_snapshot_job_scrub(RctGstSnapshotJob *job) {
+    GstElement *playbin = NULL;
+    GstElement *appsink = NULL;
+    GstBus *bus = NULL;
+    GstSample *sample = NULL;
+    GstSample *image = NULL;
+    gint64 duration = 0;
+    guint i = 0;
+
+    playbin = gst_element_factory_make("playbin", NULL);
+    appsink = gst_element_factory_make("appsink", NULL);
+
+    if (playbin == NULL || appsink == NULL) {
+        if (playbin)
+            gst_object_unref(playbin);
+
+        if (appsink)
+            gst_object_unref(appsink);
+
+        return;
+    }
+
+    g_object_set(appsink, "sync", FALSE, NULL);
+    g_object_set(playbin, "uri", job->uri, "flags", 0x1 /* video */, "video-sink", appsink, NULL);
+
+    bus = gst_element_get_bus(playbin);
+    gst_element_set_state(playbin, GST_STATE_PAUSED);
+
+    if (!rct_gst_snapshot_wait_preroll(bus) ||
+        !gst_element_query_duration(playbin, GST_FORMAT_TIME, &duration) || duration <= 0) {
+        RCT_GST_TRACE(job->self, RCT_GST_TRACE_LEVEL_ERROR, RCT_GST_TRACE_SNAPSHOT_FAILED, NULL, 0,
+                      job->uri);
+        goto out;
+    }
+
+    for (i = 0; i < job->n_thumbnails; i++) {
+        // Middle of each slice of the strip
+        gint64 position = (gint64) gst_util_uint64_scale(duration, 2 * i + 1, 2 * job->n_thumbnails);
+
+        if (!gst_element_seek_simple(playbin, GST_FORMAT_TIME,
+                                     GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT |
+                                     GST_SEEK_FLAG_SNAP_NEAREST | GST_SEEK_FLAG_TRICKMODE |
+                                     GST_SEEK_FLAG_TRICKMODE_KEY_UNITS,
+                                     position) ||
+            !rct_gst_snapshot_wait_preroll(bus))
+            break;
+
+        sample = gst_app_sink_pull_preroll(GST_APP_SINK(appsink));
+        if (sample == NULL)
+            break;
+
+        // Snapped to a key unit, the frame isn't exactly at the position asked for
+        image = rct_gst_snapshot_job_encode(job, sample);
+        if (image) {
+            GstClockTime frame_position = GST_BUFFER_PTS(gst_sample_get_buffer(sample));
+
+            g_ptr_array_add(job->thumbnails, image);
+            g_array_append_val(job->positions, frame_position);
+        }
+
+        gst_sample_unref(sample);
+    }
+
+    out:
+    gst_element_set_state(playbin, GST_STATE_NULL);
+    gst_object_unref(bus);
+    gst_object_unref(playbin);
+}
+
+static void cb_run_snapshot_job(gpointer data, gpointer user_data) {
+    (void) user_data;
+
+    RctGstSnapshotJob *job = (RctGstSnapshotJob *) data;
+
+    if (job->uri)
+        rct_gst_snapshot_job_scrub(job);
+    else if (job->sample)
+        job->image = rct_gst_snapshot_job_encode(job, job->sample);
+
+    g_mutex_lock(&job->self->stats_lock);
+
+    if (job->self->context && !g_atomic_int_get(&job->self->stopped)) {
+        job->source = g_idle_source_new();
+        g_source_set_priority(job->source, G_PRIORITY_DEFAULT);
+        g_source_set_callback(job->source, cb_deliver_snapshot, job, cb_complete_snapshot);
+        g_ptr_array_add(job->self->snapshot_sources, g_source_ref(job->source));
+        g_source_attach(job->source, job->self->context);
+        g_source_unref(job->source);
+
+        g_mutex_unlock(&job->self->stats_lock);
+        return;
+    }
+
+    g_mutex_unlock(&job->self->stats_lock);
+
+    // Not started or stopped : there's no player thread to deliver on
+    cb_deliver_snapshot(job);
+    rct_gst_snapshot_job_free(job);
+}
+
+// Shared by all players, a strip being extracted doesn't hold the snapshots back
+static GThreadPool *rct_gst_player_get_snapshot_workers(void) {
+    static gsize workers = 0;
+
+    if (g_once_init_enter(&workers)) {
+        GThreadPool *pool = g_thread_pool_new(cb_run_snapshot_job, NULL, 2, FALSE, NULL);
+        g_once_init_leave(&workers, (gsize) pool);
+    }
+
+    return (GThreadPool *) workers;
+}
+
+static RctGstSnapshotJob *rct_gst_snapshot_job_new(RctGstPlayer *self,
+                                                   gint width,
+                                                   gint height,
+                                                   RctGstSnapshotFormat format,
+                                                   gpointer user_data) {
+    RctGstSnapshotJob *job = NULL;
+
+    job = g_malloc0(sizeof(RctGstSnapshotJob));
+    job->self = g_object_ref(self);
+    job->width = width;
+    job->height = height;
+    job->format = format;
+    job->user_data = user_data;
+    job->thumbnails = g_ptr_array_new_with_free_func((GDestroyNotify) gst_sample_unref);
+    job->positions = g_array_new(FALSE, FALSE, sizeof(GstClockTime));
+
+    return job;
+}
+
+// Last sample of the first video sink keeping one
+static GstSample *rct_gst_player_get_last_sample(RctGstPlayer *self) {
+    GstPipeline *pipeline = NULL;
+    GstIterator *iterator = NULL;
+    GValue item = G_VALUE_INIT;
+    GstSample *sample = NULL;
+    GstCaps *caps = NULL;
+    gboolean done = FALSE;
+
+    g_mutex_lock(&self->stats_lock);
+    if (self->pipeline)
+        pipeline = gst_object_ref(self->pipeline);
+    g_mutex_unlock(&self->stats_lock);
+
+    if (pipeline == NULL)
+        return NULL;
+
+    iterator = gst_bin_iterate_sinks(GST_BIN(pipeline));
+
+    while (!done && sample == NULL) {
+        switch (gst_iterator_next(iterator, &item)) {
+            case GST_ITERATOR_OK: {
+                GstElement *element = GST_ELEMENT(g_value_get_object(&item));
+
+                if (rct_gst_element_has_property(element, "last-sample"))
+                    g_object_get(element, "last-sample", &sample, NULL);
+
+                caps = sample ? gst_sample_get_caps(sample) : NULL;
+                if (sample && (caps == NULL || gst_caps_get_size(caps) == 0 ||
+                               !g_str_has_prefix(gst_structure_get_name(gst_caps_get_structure(caps, 0)),
+                                                 "video/"))) {
+                    gst_sample_unref(sample);
+                    sample = NULL;
+                }
+
+                g_value_reset(&item);
+                break;
+            }
+
+            case GST_ITERATOR_RESYNC:
+                gst_iterator_resync(iterator);
+                break;
+
+            default:
+                done = TRUE;
+                break;
+        }
+    }
+
+    g_value_unset(&item);
+    gst_iterator_free(iterator);
+    gst_object_unref(pipeline);
+
+    return sample;
+}
+
+void rct_gst_player_snapshot(RctGstPlayer *self,
+                             gint width,
+                             gint height,
+                             RctGstSnapshotFormat format,
+                             RctGstSnapshotCallback callback,
+                             gpointer user_data) {
+    RctGstSnapshotJob *job = NULL;
+
+    job = rct_gst_snapshot_job_new(self, width, height, format, user_data);
+    job->snapshot_callback = callback;
+    job->sample = rct_gst_player_get_last_sample(self);
+
+    g_thread_pool_push(rct_gst_player_get_snapshot_workers(), job, NULL);
+}
+
+void rct_gst_player_snapshot_frame(RctGstPlayer *self,
+                                   const GstVideoFrame *frame,
+                                   gint width,
+                                   gint height,
+                                   RctGstSnapshotFormat format,
+                                   RctGstSnapshotCallback callback,
+                                   gpointer user_data) {
+    RctGstSnapshotJob *job = NULL;
+    GstCaps *caps = NULL;
+
+    job = rct_gst_snapshot_job_new(self, width, height, format, user_data);
+    job->snapshot_callback = callback;
+
+    // The buffer is shared, not copied : the frame can be released right away
+    caps = gst_video_info_to_caps((GstVideoInfo *) &frame->info);
+    job->sample = gst_sample_new(frame->buffer, caps, NULL, NULL);
+    gst_caps_unref(caps);
+
+    g_thread_pool_push(rct_gst_player_get_snapshot_workers(), job, NULL);
+}
+
+void rct_gst_player_extract_thumbnails(RctGstPlayer *self,
+                                       const gchar *uri,
+                                       guint n_thumbnails,
+                                       gint width,
+                                       gint height,
+                                       RctGstSnapshotFormat format,
+                                       RctGstThumbnailsCallback callback,
+                                       gpointer user_data) {
+    RctGstSnapshotJob *job = NULL;
+
+    job = rct_gst_snapshot_job_new(self, width, height, format, user_data);
+    job->thumbnails_callback = callback;
+    job->uri = g_strdup(uri);
+    job->n_thumbnails = n_thumbnails;
+
+    g_thread_pool_push(rct_gst_player_get_snapshot_workers(), job, NULL);
+}
+
+// Commands
+static RctGstCommand *rct_gst_command_new(RctGstCommandType type,
+                                          RctGstPlayerCommandCallback callback,
+                                          gpointer callback_data) {
+    RctGstCommand *command = NULL;
+
+    command = g_malloc0(sizeof(RctGstCommand));
+    command->type = type;
+    command->callback = callback;
+    command->callback_data = callback_data;
+
+    return command;
+}
+
+static void rct_gst_command_complete(RctGstPlayer *self, RctGstCommand *command, gboolean applied) {
+    if (command->callback)
+        command->callback(self, applied, command->callback_data);
+
+    // Payloads are owned by the player once applied
+    if (!applied && command->pointer) {
+        switch (command->type) {
+            case RCT_GST_COMMAND_PROPERTY_BATCH:
+                rct_gst_property_batch_free(command->pointer);
+                break;
+
+            case RCT_GST_COMMAND_SUBSCRIBE:
+                rct_gst_message_subscription_free(command->pointer);
+                break;
+
+            case RCT_GST_COMMAND_ADD_FRAME_TAP:
+                rct_gst_frame_tap_unref(command->pointer);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    g_free(command->string);
+    g_free(command);
+}
+
+// Only the last of consecutive commands of these types is worth applying
+static gboolean rct_gst_command_is_coalescable(RctGstCommand *command) {
+    return command->type == RCT_GST_COMMAND_DESIRED_STATE ||
+           command->type == RCT_GST_COMMAND_PARSE_LAUNCH_PIPELINE ||
+           command->type == RCT_GST_COMMAND_DRAWABLE_SURFACE ||
+           command->type == RCT_GST_COMMAND_STATS_INTERVAL ||
+           command->type == RCT_GST_COMMAND_SEEK ||
+           command->type == RCT_GST_COMMAND_POSITION_UPDATE_INTERVAL;
+}
+
+static void rct_gst_player_apply_command(RctGstPlayer *self, RctGstCommand *command) {
+    switch (command->type) {
+        case RCT_GST_COMMAND_DESIRED_STATE:
+            rct_gst_player_set_desired_state(self, command->state);
+            break;
+
+        case RCT_GST_COMMAND_PARSE_LAUNCH_PIPELINE:
+            // Pipelines set by the application take over from the playlist
+            rct_gst_player_leave_playlist(self);
+            rct_gst_player_set_parse_launch_pipeline(self, command->string);
+            command->string = NULL;
+            break;
+
+        case RCT_GST_COMMAND_DRAWABLE_SURFACE:
+            rct_gst_player_set_drawable_surface(self, command->pointer);
+            break;
+
+        case RCT_GST_COMMAND_PIPELINE_PROPERTIES:
+            rct_gst_player_apply_pipeline_properties(self, command->string);
+            break;
+
+        case RCT_GST_COMMAND_PROPERTY_BATCH:
+            rct_gst_player_apply_property_batch(self, command->pointer);
+            command->pointer = NULL;
+            break;
+
+        case RCT_GST_COMMAND_ELEMENT_MESSAGE_RATE_LIMIT:
+            rct_gst_player_apply_element_message_rate_limit(self, command->string, command->value);
+            break;
+
+        case RCT_GST_COMMAND_SUBSCRIBE:
+            rct_gst_player_apply_subscription(self, command->pointer);
+            break;
+
+        case RCT_GST_COMMAND_UNSUBSCRIBE:
+            rct_gst_player_apply_unsubscription(self, command->value);
+            break;
+
+        case RCT_GST_COMMAND_STATS_INTERVAL:
+            rct_gst_player_apply_stats_interval(self, command->value);
+            break;
+
+        case RCT_GST_COMMAND_ADD_FRAME_TAP:
+            rct_gst_player_apply_frame_tap(self, command->pointer);
+            break;
+
+        case RCT_GST_COMMAND_REMOVE_FRAME_TAP:
+            rct_gst_player_apply_frame_tap_removal(self, command->value);
+            break;
+
+        case RCT_GST_COMMAND_SEEK:
+            rct_gst_player_seek(self, command->position, (RctGstSeekMode) command->value);
+            break;
+
+        case RCT_GST_COMMAND_POSITION_UPDATE_INTERVAL:
+            rct_gst_player_apply_position_update_interval(self, command->value);
+            break;
+
+        case RCT_GST_COMMAND_PLAYLIST_ENQUEUE:
+            rct_gst_player_apply_playlist_enqueue(self, command->string);
+            command->string = NULL;
+            break;
+
+        case RCT_GST_COMMAND_PLAYLIST_SKIP:
+            rct_gst_player_apply_playlist_skip(self);
+            break;
+
+        case RCT_GST_COMMAND_PLAYLIST_CLEAR:
+            rct_gst_player_apply_playlist_clear(self);
+            break;
+
+        case RCT_GST_COMMAND_STOP:
+            rct_gst_player_apply_stop(self);
+            break;
+    }
 }
 
-static void rct_gst_player_set_desired_state(RctGstPlayer *self, GstState state) {
-    g_print("%s : Setting pipeline state: %s\n", self->debug_tag,
-           gst_element_state_get_name(state));
+// Empties the stack, returning the commands oldest first
+static RctGstCommand *rct_gst_player_take_commands(RctGstPlayer *self) {
+    RctGstCommand *commands = NULL;
+    RctGstCommand *command = NULL;
+    RctGstCommand *fifo = NULL;
+
+    do {
+        commands = g_atomic_pointer_get(&self->commands);
+    } while (!g_atomic_pointer_compare_and_exchange(&self->commands, commands, NULL));
+
+    while (commands != NULL) {
+        command = commands;
+        commands = command->next;
+        command->next = fifo;
+        fifo = command;
+    }
 
-    gst_element_set_state(GST_ELEMENT(self->pipeline), state);
+    return fifo;
 }
 
-static void rct_gst_player_set_parse_launch_pipeline(RctGstPlayer *self,
-                                                     gchar *parse_launch_pipeline) {
-    GstBus *bus;
+static gboolean cb_drain_commands(gpointer data) {
+    RctGstPlayer *self = NULL;
+    RctGstCommand *command = NULL;
+    RctGstCommand *fifo = NULL;
 
-    if (self->pipeline) {
-        g_print("%s : Cleaning old pipeline: %p\n", self->debug_tag,
-               self->pipeline);
+    self = (RctGstPlayer *) data;
 
-        GstBus *current_bus;
+    // Reset first : commands posted from now on schedule another drain
+    g_atomic_int_set(&self->commands_scheduled, FALSE);
 
-        current_bus = gst_pipeline_get_bus(self->pipeline);
-        gst_bus_remove_watch(current_bus);
+    fifo = rct_gst_player_take_commands(self);
 
-        gst_element_set_state(GST_ELEMENT(self->pipeline), GST_STATE_NULL);
+    while (fifo != NULL) {
+        command = fifo;
+        fifo = command->next;
 
-        gst_object_unref(current_bus);
+        if (g_atomic_int_get(&self->stopped)) {
+            rct_gst_command_complete(self, command, FALSE);
+            continue;
+        }
 
-        gst_object_unref(self->pipeline);
-        self->pipeline = NULL;
-    }
+        if (fifo != NULL && fifo->type == command->type && rct_gst_command_is_coalescable(command)) {
+            if (command->type == RCT_GST_COMMAND_SEEK) {
+                g_mutex_lock(&self->stats_lock);
+                self->seeks_superseded++;
+                g_mutex_unlock(&self->stats_lock);
+            }
 
-    g_print("%s : Creating new pipeline\n", self->debug_tag);
+            rct_gst_command_complete(self, command, FALSE);
+            continue;
+        }
 
-    self->parse_launch_pipeline = parse_launch_pipeline;
-    g_print("%s : Setting property parse_launch_pipeline: %s\n", self->debug_tag,
-           self->parse_launch_pipeline);
+        rct_gst_player_apply_command(self, command);
+        rct_gst_command_complete(self, command, TRUE);
+    }
 
-    self->pipeline = GST_PIPELINE(gst_parse_launch(self->parse_launch_pipeline, NULL));
-    bus = gst_pipeline_get_bus(self->pipeline);
+    return G_SOURCE_REMOVE;
+}
 
-    gst_bus_add_watch(bus, cb_bus_watch, (gpointer) self);
+// Completes the commands left once the player stopped
+static void rct_gst_player_discard_commands(RctGstPlayer *self) {
+    RctGstCommand *command = NULL;
+    RctGstCommand *fifo = NULL;
 
-    rct_gst_player_set_desired_state(self, self->desired_state);
+    fifo = rct_gst_player_take_commands(self);
 
-    gst_object_unref(bus);
+    while (fifo != NULL) {
+        command = fifo;
+        fifo = command->next;
+        rct_gst_command_complete(self, command, FALSE);
+    }
 }
 
-static GstElement *rct_gst_player_get_element(RctGstPlayer *self,
-                                              const gchar *element_name) {
+static void rct_gst_player_post_command(RctGstPlayer *self, RctGstCommand *command) {
+    RctGstCommand *head = NULL;
+    GSource *source = NULL;
 
-    GstElement *element = NULL;
+    // Not started yet : there's no player thread to race with
+    if (self->context == NULL) {
+        rct_gst_player_apply_command(self, command);
+        rct_gst_command_complete(self, command, TRUE);
+        return;
+    }
+
+    do {
+        head = g_atomic_pointer_get(&self->commands);
+        command->next = head;
+    } while (!g_atomic_pointer_compare_and_exchange(&self->commands, head, command));
+
+    if (g_atomic_int_compare_and_exchange(&self->commands_scheduled, FALSE, TRUE)) {
+        source = g_idle_source_new();
+        g_source_set_priority(source, G_PRIORITY_DEFAULT);
+        g_source_set_callback(source, cb_drain_commands, g_object_ref(self), g_object_unref);
+        g_source_attach(source, self->context);
+        g_source_unref(source);
+    }
+}
 
-    element = gst_bin_get_by_name(GST_BIN (self->pipeline), element_name);
-    if (element == NULL) {
-        gchar *error_detail = g_strdup_printf("Element %s doesn't exists", element_name);
+void rct_gst_player_post_desired_state(RctGstPlayer *self,
+                                       GstState state,
+                                       RctGstPlayerCommandCallback callback,
+                                       gpointer user_data) {
+    RctGstCommand *command = NULL;
 
-        if (self->on_rct_gst_pipeline_error)
-            self->on_rct_gst_pipeline_error(self, "pipeline", error_detail, "");
+    command = rct_gst_command_new(RCT_GST_COMMAND_DESIRED_STATE, callback, user_data);
+    command->state = state;
+    rct_gst_player_post_command(self, command);
+}
 
-        g_free(error_detail);
-        return NULL;
-    }
+void rct_gst_player_post_parse_launch_pipeline(RctGstPlayer *self,
+                                               const gchar *parse_launch_pipeline,
+                                               RctGstPlayerCommandCallback callback,
+                                               gpointer user_data) {
+    RctGstCommand *command = NULL;
 
-    return element;
+    command = rct_gst_command_new(RCT_GST_COMMAND_PARSE_LAUNCH_PIPELINE, callback, user_data);
+    command->string = g_strdup(parse_launch_pipeline);
+    rct_gst_player_post_command(self, command);
 }
 
-static void rct_gst_player_set_element_property(RctGstPlayer *self,
-                                                const gchar *element_name,
-                                                const gchar *property_name,
-                                                JsonNode *property_node) {
-    GstElement *element = NULL;
-    GValue value = G_VALUE_INIT;
+void rct_gst_player_post_drawable_surface(RctGstPlayer *self,
+                                          gpointer drawable_surface,
+                                          RctGstPlayerCommandCallback callback,
+                                          gpointer user_data) {
+    RctGstCommand *command = NULL;
 
-    element = rct_gst_player_get_element(self, element_name);
-    if (element == NULL)
-        return;
+    // Readable right away, so that bindings can release the surface they replace
+    g_atomic_pointer_set(&self->drawable_surface, drawable_surface);
 
-    json_node_get_value(property_node, &value);
-    g_object_set_property(G_OBJECT(element), property_name, &value);
-    g_value_unset(&value);
+    command = rct_gst_command_new(RCT_GST_COMMAND_DRAWABLE_SURFACE, callback, user_data);
+    command->pointer = drawable_surface;
+    rct_gst_player_post_command(self, command);
 }
 
-void rct_gst_player_lookup_properties(RctGstPlayer *self,
-                                      JsonNode *node,
-                                      const gchar *element_name,
-                                      const gchar *property_name) {
-    GType node_type = json_node_get_value_type(node);
+void rct_gst_player_post_seek(RctGstPlayer *self,
+                              GstClockTime position,
+                              RctGstSeekMode mode,
+                              RctGstPlayerCommandCallback callback,
+                              gpointer user_data) {
+    RctGstCommand *command = NULL;
+
+    command = rct_gst_command_new(RCT_GST_COMMAND_SEEK, callback, user_data);
+    command->position = position;
+    command->value = mode;
+    rct_gst_player_post_command(self, command);
+}
 
-    if (element_name != NULL && property_name != NULL) {
-        rct_gst_player_set_element_property(self, element_name, property_name, node);
-    }
+void rct_gst_player_post_playlist_enqueue(RctGstPlayer *self,
+                                          const gchar *item,
+                                          RctGstPlayerCommandCallback callback,
+                                          gpointer user_data) {
+    RctGstCommand *command = NULL;
 
-    if (node_type == JSON_TYPE_OBJECT) {
-        JsonObject *object = NULL;
-        JsonObjectIter object_iterator;
-        const gchar *member_name;
-        JsonNode *member_node = NULL;
+    command = rct_gst_command_new(RCT_GST_COMMAND_PLAYLIST_ENQUEUE, callback, user_data);
+    command->string = g_strdup(item);
+    rct_gst_player_post_command(self, command);
+}
 
-        object = json_node_get_object(node);
-        json_object_iter_init(&object_iterator, object);
+void rct_gst_player_post_playlist_skip(RctGstPlayer *self,
+                                       RctGstPlayerCommandCallback callback,
+                                       gpointer user_data) {
+    rct_gst_player_post_command(self, rct_gst_command_new(RCT_GST_COMMAND_PLAYLIST_SKIP, callback, user_data));
+}
 
-        while (json_object_iter_next(&object_iterator, &member_name, &member_node)) {
-            if (element_name != NULL)
-                rct_gst_player_lookup_properties(self, member_node, element_name, member_name);
-            else
-                rct_gst_player_lookup_properties(self, member_node, member_name, NULL);
-        }
-    }
+void rct_gst_player_post_playlist_clear(RctGstPlayer *self,
+                                        RctGstPlayerCommandCallback callback,
+                                        gpointer user_data) {
+    rct_gst_player_post_command(self, rct_gst_command_new(RCT_GST_COMMAND_PLAYLIST_CLEAR, callback, user_data));
 }
 
-void rct_gst_player_set_pipeline_properties(RctGstPlayer *self, const gchar *pipeline_properties) {
+void rct_gst_player_get_seek_stats(RctGstPlayer *self, guint64 *superseded) {
+    g_mutex_lock(&self->stats_lock);
 
-    JsonParser *parser = NULL;
-    GError *error = NULL;
-    JsonNode *elements_node = NULL;
+    if (superseded)
+        *superseded = self->seeks_superseded;
 
-    parser = json_parser_new();
-    json_parser_load_from_data(parser, pipeline_properties, -1, &error);
-    if (error != NULL) {
-        g_print("%s : Unable to parse '%s': %s\n", self->debug_tag, pipeline_properties,
-                  error->message);
+    g_mutex_unlock(&self->stats_lock);
+}
 
-        g_error_free(error);
-        g_object_unref(parser);
-        return;
-    }
+void rct_gst_player_post_pipeline_properties(RctGstPlayer *self,
+                                             const gchar *pipeline_properties,
+                                             RctGstPlayerCommandCallback callback,
+                                             gpointer user_data) {
+    RctGstCommand *command = NULL;
 
-    elements_node = json_parser_get_root(parser);
-    rct_gst_player_lookup_properties(self, elements_node, NULL, NULL);
+    command = rct_gst_command_new(RCT_GST_COMMAND_PIPELINE_PROPERTIES, callback, user_data);
+    command->string = g_strdup(pipeline_properties);
+    rct_gst_player_post_command(self, command);
+}
+
+void rct_gst_player_post_property_batch(RctGstPlayer *self,
+                                        RctGstPropertyBatch *batch,
+                                        RctGstPlayerCommandCallback callback,
+                                        gpointer user_data) {
+    RctGstCommand *command = NULL;
+
+    command = rct_gst_command_new(RCT_GST_COMMAND_PROPERTY_BATCH, callback, user_data);
+    command->pointer = batch;
+    rct_gst_player_post_command(self, command);
 }
 
 // Object properties
@@ -486,6 +6918,34 @@ enum {
     PROP_CB_ON_RCT_GST_ELEMENT_MESSAGE_TAG,
     PROP_USER_DATA_TAG,
     PROP_DESIRED_STATE_TAG,
+    PROP_PIPELINE_CACHE_SIZE_TAG,
+    PROP_PIPELINE_CACHE_STATE_TAG,
+    PROP_INCREMENTAL_RECONFIGURATION_TAG,
+    PROP_ASYNC_TEARDOWN_TAG,
+    PROP_CB_ON_RCT_GST_PIPELINE_TEARDOWN_TAG,
+    PROP_USE_SHARED_EXECUTOR_TAG,
+    PROP_ELEMENT_MESSAGE_FORMAT_TAG,
+    PROP_CB_ON_RCT_GST_ELEMENT_MESSAGE_BINARY_TAG,
+    PROP_PROPERTY_BATCH_INTERVAL_TAG,
+    PROP_PROPERTY_BATCH_FRAME_ALIGNED_TAG,
+    PROP_TRACE_LEVEL_TAG,
+    PROP_STATS_INTERVAL_TAG,
+    PROP_CB_ON_RCT_GST_PLAYER_STATS_TAG,
+    PROP_CB_ON_RCT_GST_STARTUP_TIMINGS_TAG,
+    PROP_CB_ON_RCT_GST_SEEK_DONE_TAG,
+    PROP_POSITION_UPDATE_INTERVAL_TAG,
+    PROP_POSITION_UPDATE_THRESHOLD_TAG,
+    PROP_CB_ON_RCT_GST_PIPELINE_POSITION_TAG,
+    PROP_LIVE_LOW_LATENCY_TAG,
+    PROP_LIVE_LATENCY_TAG,
+    PROP_BUFFERING_MODE_TAG,
+    PROP_BUFFERING_LOW_WATERMARK_TAG,
+    PROP_BUFFERING_HIGH_WATERMARK_TAG,
+    PROP_CB_ON_RCT_GST_BUFFERING_TAG,
+    PROP_PLAYLIST_LOOP_TAG,
+    PROP_CB_ON_RCT_GST_PLAYLIST_ITEM_TAG,
+    PROP_MEMORY_BUDGET_TAG,
+    PROP_CB_ON_RCT_GST_MEMORY_BUDGET_TAG,
     N_PROPERTIES
 };
 static GParamSpec *obj_properties[N_PROPERTIES] = {
@@ -505,12 +6965,11 @@ rct_gst_player_set_property(GObject *object, guint property_id, const GValue *va
             break;
 
         case PROP_PARSE_LAUNCH_PIPELINE_TAG:
-            g_free(self->parse_launch_pipeline);
-            rct_gst_player_set_parse_launch_pipeline(self, g_value_dup_string(value));
+            rct_gst_player_post_parse_launch_pipeline(self, g_value_get_string(value), NULL, NULL);
             break;
 
         case PROP_DRAWABLE_SURFACE_TAG:
-            rct_gst_player_set_drawable_surface(self, g_value_get_pointer(value));
+            rct_gst_player_post_drawable_surface(self, g_value_get_pointer(value), NULL, NULL);
             break;
 
         case PROP_CB_ON_RCT_GST_PLAYER_LOADED_TAG:
@@ -538,8 +6997,131 @@ rct_gst_player_set_property(GObject *object, guint property_id, const GValue *va
             break;
 
         case PROP_DESIRED_STATE_TAG:
-            self->desired_state = (GstState) g_value_get_int(value);
-            rct_gst_player_set_desired_state(self, self->desired_state);
+            rct_gst_player_post_desired_state(self, (GstState) g_value_get_int(value), NULL, NULL);
+            break;
+
+        case PROP_PIPELINE_CACHE_SIZE_TAG:
+            rct_gst_player_set_pipeline_cache_size(self, g_value_get_uint(value));
+            break;
+
+        case PROP_PIPELINE_CACHE_STATE_TAG:
+            self->pipeline_cache_state = (GstState) g_value_get_int(value);
+            break;
+
+        case PROP_INCREMENTAL_RECONFIGURATION_TAG:
+            self->incremental_reconfiguration = g_value_get_boolean(value);
+            break;
+
+        case PROP_ASYNC_TEARDOWN_TAG:
+            self->async_teardown = g_value_get_boolean(value);
+            break;
+
+        case PROP_CB_ON_RCT_GST_PIPELINE_TEARDOWN_TAG:
+            self->on_rct_gst_pipeline_teardown = g_value_get_pointer(value);
+            break;
+
+        case PROP_USE_SHARED_EXECUTOR_TAG:
+            self->use_shared_executor = g_value_get_boolean(value);
+            break;
+
+        case PROP_ELEMENT_MESSAGE_FORMAT_TAG:
+            self->element_message_format = (RctGstMessageFormat) g_value_get_int(value);
+            break;
+
+        case PROP_CB_ON_RCT_GST_ELEMENT_MESSAGE_BINARY_TAG:
+            self->on_rct_gst_element_message_binary = g_value_get_pointer(value);
+            break;
+
+        case PROP_PROPERTY_BATCH_INTERVAL_TAG:
+            self->property_batch_interval = g_value_get_uint(value);
+            break;
+
+        case PROP_PROPERTY_BATCH_FRAME_ALIGNED_TAG:
+            self->property_batch_frame_aligned = g_value_get_boolean(value);
+            break;
+
+        case PROP_TRACE_LEVEL_TAG:
+            g_atomic_int_set(&self->trace_level, g_value_get_int(value));
+            break;
+
+        case PROP_STATS_INTERVAL_TAG: {
+            RctGstCommand *command = NULL;
+
+            command = rct_gst_command_new(RCT_GST_COMMAND_STATS_INTERVAL, NULL, NULL);
+            command->value = g_value_get_uint(value);
+            rct_gst_player_post_command(self, command);
+            break;
+        }
+
+        case PROP_CB_ON_RCT_GST_PLAYER_STATS_TAG:
+            self->on_rct_gst_player_stats = g_value_get_pointer(value);
+            break;
+
+        case PROP_CB_ON_RCT_GST_STARTUP_TIMINGS_TAG:
+            self->on_rct_gst_startup_timings = g_value_get_pointer(value);
+            break;
+
+        case PROP_CB_ON_RCT_GST_SEEK_DONE_TAG:
+            self->on_rct_gst_seek_done = g_value_get_pointer(value);
+            break;
+
+        case PROP_POSITION_UPDATE_INTERVAL_TAG: {
+            RctGstCommand *command = NULL;
+
+            command = rct_gst_command_new(RCT_GST_COMMAND_POSITION_UPDATE_INTERVAL, NULL, NULL);
+            command->value = g_value_get_uint(value);
+            rct_gst_player_post_command(self, command);
+            break;
+        }
+
+        case PROP_POSITION_UPDATE_THRESHOLD_TAG:
+            self->position_update_threshold = g_value_get_uint(value);
+            break;
+
+        case PROP_CB_ON_RCT_GST_PIPELINE_POSITION_TAG:
+            self->on_rct_gst_pipeline_position = g_value_get_pointer(value);
+            break;
+
+        case PROP_LIVE_LOW_LATENCY_TAG:
+            self->live_low_latency = g_value_get_boolean(value);
+            break;
+
+        case PROP_LIVE_LATENCY_TAG:
+            self->live_latency = g_value_get_uint(value);
+            break;
+
+        case PROP_BUFFERING_MODE_TAG:
+            self->buffering_mode = (RctGstBufferingMode) g_value_get_int(value);
+            break;
+
+        case PROP_BUFFERING_LOW_WATERMARK_TAG:
+            self->buffering_low_watermark = g_value_get_uint(value);
+            break;
+
+        case PROP_BUFFERING_HIGH_WATERMARK_TAG:
+            self->buffering_high_watermark = g_value_get_uint(value);
+            break;
+
+        case PROP_CB_ON_RCT_GST_BUFFERING_TAG:
+            self->on_rct_gst_buffering = g_value_get_pointer(value);
+            break;
+
+        case PROP_PLAYLIST_LOOP_TAG:
+            g_mutex_lock(&self->stats_lock);
+            self->playlist_loop = g_value_get_boolean(value);
+            g_mutex_unlock(&self->stats_lock);
+            break;
+
+        case PROP_CB_ON_RCT_GST_PLAYLIST_ITEM_TAG:
+            self->on_rct_gst_playlist_item = g_value_get_pointer(value);
+            break;
+
+        case PROP_MEMORY_BUDGET_TAG:
+            self->memory_budget = g_value_get_uint64(value);
+            break;
+
+        case PROP_CB_ON_RCT_GST_MEMORY_BUDGET_TAG:
+            self->on_rct_gst_memory_budget = g_value_get_pointer(value);
             break;
 
         default:
@@ -593,6 +7175,120 @@ rct_gst_player_get_property(GObject *object, guint property_id, GValue *value, G
             g_value_set_int(value, (int) self->desired_state);
             break;
 
+        case PROP_PIPELINE_CACHE_SIZE_TAG:
+            g_value_set_uint(value, self->pipeline_cache_size);
+            break;
+
+        case PROP_PIPELINE_CACHE_STATE_TAG:
+            g_value_set_int(value, (int) self->pipeline_cache_state);
+            break;
+
+        case PROP_INCREMENTAL_RECONFIGURATION_TAG:
+            g_value_set_boolean(value, self->incremental_reconfiguration);
+            break;
+
+        case PROP_ASYNC_TEARDOWN_TAG:
+            g_value_set_boolean(value, self->async_teardown);
+            break;
+
+        case PROP_CB_ON_RCT_GST_PIPELINE_TEARDOWN_TAG:
+            g_value_set_pointer(value, self->on_rct_gst_pipeline_teardown);
+            break;
+
+        case PROP_USE_SHARED_EXECUTOR_TAG:
+            g_value_set_boolean(value, self->use_shared_executor);
+            break;
+
+        case PROP_ELEMENT_MESSAGE_FORMAT_TAG:
+            g_value_set_int(value, (int) self->element_message_format);
+            break;
+
+        case PROP_CB_ON_RCT_GST_ELEMENT_MESSAGE_BINARY_TAG:
+            g_value_set_pointer(value, self->on_rct_gst_element_message_binary);
+            break;
+
+        case PROP_PROPERTY_BATCH_INTERVAL_TAG:
+            g_value_set_uint(value, self->property_batch_interval);
+            break;
+
+        case PROP_PROPERTY_BATCH_FRAME_ALIGNED_TAG:
+            g_value_set_boolean(value, self->property_batch_frame_aligned);
+            break;
+
+        case PROP_TRACE_LEVEL_TAG:
+            g_value_set_int(value, g_atomic_int_get(&self->trace_level));
+            break;
+
+        case PROP_STATS_INTERVAL_TAG:
+            g_value_set_uint(value, self->stats_interval);
+            break;
+
+        case PROP_CB_ON_RCT_GST_PLAYER_STATS_TAG:
+            g_value_set_pointer(value, self->on_rct_gst_player_stats);
+            break;
+
+        case PROP_CB_ON_RCT_GST_STARTUP_TIMINGS_TAG:
+            g_value_set_pointer(value, self->on_rct_gst_startup_timings);
+            break;
+
+        case PROP_CB_ON_RCT_GST_SEEK_DONE_TAG:
+            g_value_set_pointer(value, self->on_rct_gst_seek_done);
+            break;
+
+        case PROP_POSITION_UPDATE_INTERVAL_TAG:
+            g_value_set_uint(value, self->position_update_interval);
+            break;
+
+        case PROP_POSITION_UPDATE_THRESHOLD_TAG:
+            g_value_set_uint(value, self->position_update_threshold);
+            break;
+
+        case PROP_CB_ON_RCT_GST_PIPELINE_POSITION_TAG:
+            g_value_set_pointer(value, self->on_rct_gst_pipeline_position);
+            break;
+
+        case PROP_LIVE_LOW_LATENCY_TAG:
+            g_value_set_boolean(value, self->live_low_latency);
+            break;
+
+        case PROP_LIVE_LATENCY_TAG:
+            g_value_set_uint(value, self->live_latency);
+            break;
+
+        case PROP_BUFFERING_MODE_TAG:
+            g_value_set_int(value, (int) self->buffering_mode);
+            break;
+
+        case PROP_BUFFERING_LOW_WATERMARK_TAG:
+            g_value_set_uint(value, self->buffering_low_watermark);
+            break;
+
+        case PROP_BUFFERING_HIGH_WATERMARK_TAG:
+            g_value_set_uint(value, self->buffering_high_watermark);
+            break;
+
+        case PROP_CB_ON_RCT_GST_BUFFERING_TAG:
+            g_value_set_pointer(value, self->on_rct_gst_buffering);
+            break;
+
+        case PROP_PLAYLIST_LOOP_TAG:
+            g_mutex_lock(&self->stats_lock);
+            g_value_set_boolean(value, self->playlist_loop);
+            g_mutex_unlock(&self->stats_lock);
+            break;
+
+        case PROP_CB_ON_RCT_GST_PLAYLIST_ITEM_TAG:
+            g_value_set_pointer(value, self->on_rct_gst_playlist_item);
+            break;
+
+        case PROP_MEMORY_BUDGET_TAG:
+            g_value_set_uint64(value, self->memory_budget);
+            break;
+
+        case PROP_CB_ON_RCT_GST_MEMORY_BUDGET_TAG:
+            g_value_set_pointer(value, self->on_rct_gst_memory_budget);
+            break;
+
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, property_id, pspec);
             break;
@@ -607,17 +7303,87 @@ static void rct_gst_player_dispose(GObject *object) {
 
 static void rct_gst_player_finalize(GObject *object) {
     RctGstPlayer *self = RCT_GST_PLAYER(object);
+    guint i = 0;
 
     g_print("%s : Finalizing Gst Player...", self->debug_tag);
+
+    // The reaper would reference a finalized player
+    self->async_teardown = FALSE;
+    self->on_rct_gst_pipeline_teardown = NULL;
+
+    rct_gst_player_discard_commands(self);
+
+    rct_gst_player_unwatch_bus(self);
+    g_mutex_clear(&self->bus_queue_lock);
+    rct_gst_player_clear_pipeline_cache(self);
+    g_queue_free(self->pipeline_cache);
+
+    rct_gst_player_unwatch_playlist(self);
+    rct_gst_player_clear_preloaded_pipeline(self);
+    g_ptr_array_unref(self->playlist);
+
+    g_hash_table_unref(self->message_throttles);
+    g_mutex_clear(&self->element_messages_lock);
+
+    g_ptr_array_unref(self->message_subscriptions);
+    g_array_unref(self->message_fields);
+
+    rct_gst_player_clear_source(&self->property_batch_source);
+    g_ptr_array_unref(self->pending_writes);
+    g_hash_table_unref(self->element_targets);
+
+    rct_gst_player_clear_startup_probes(self);
+    g_ptr_array_unref(self->startup_probes);
+
+    rct_gst_player_clear_latency_profile(self);
+    g_ptr_array_unref(self->latency_probes);
+
+    rct_gst_player_clear_memory_budget(self);
+    g_ptr_array_unref(self->budget_queues);
+
+    // Late frames of the branches would reference a finalized player
+    for (i = 0; i < self->frame_taps->len; i++) {
+        GstElement *appsink = rct_gst_frame_tap_disarm(g_ptr_array_index(self->frame_taps, i), TRUE);
+
+        if (appsink)
+            gst_object_unref(appsink);
+    }
+
+    g_ptr_array_unref(self->frame_taps);
+    g_ptr_array_unref(self->snapshot_sources);
+
+    rct_gst_player_clear_source(&self->stats_source);
+    rct_gst_player_clear_source(&self->position_source);
+    g_hash_table_unref(self->qos_stats);
+    g_mutex_clear(&self->stats_lock);
+
+    g_free(self->trace_records);
     g_free(self->debug_tag);
     g_free(self->parse_launch_pipeline);
-    g_main_loop_unref(self->loop);
+    g_byte_array_unref(self->message_buffer);
 
-    g_thread_unref(self->thread);
+    if (self->loop)
+        g_main_loop_unref(self->loop);
+
+    if (self->context)
+        g_main_context_unref(self->context);
+
+    if (self->thread)
+        g_thread_unref(self->thread);
 
     self->debug_tag = NULL;
     self->parse_launch_pipeline = NULL;
     self->loop = NULL;
+    self->context = NULL;
+    self->pipeline_cache = NULL;
+    self->message_buffer = NULL;
+    self->message_throttles = NULL;
+    self->message_subscriptions = NULL;
+    self->message_fields = NULL;
+    self->element_targets = NULL;
+    self->pending_writes = NULL;
+    self->trace_records = NULL;
+    self->qos_stats = NULL;
 }
 
 static void __unused rct_gst_player_class_init(RctGstPlayerClass *klass) {
@@ -693,15 +7459,379 @@ static void __unused rct_gst_player_class_init(RctGstPlayerClass *klass) {
                              GST_STATE_VOID_PENDING,
                              G_PARAM_READWRITE);
 
+    obj_properties[PROP_PIPELINE_CACHE_SIZE_TAG] =
+            g_param_spec_uint("pipeline_cache_size",
+                              "Pipeline Cache Size",
+                              "Maximum number of previous pipelines kept built for instant switching (0 disables the cache)",
+                              0,
+                              16,
+                              0,
+                              G_PARAM_READWRITE);
+
+    obj_properties[PROP_PIPELINE_CACHE_STATE_TAG] =
+            g_param_spec_int("pipeline_cache_state",
+                             "Pipeline Cache State",
+                             "State in which cached pipelines are kept (READY or PAUSED)",
+                             GST_STATE_READY,
+                             GST_STATE_PAUSED,
+                             GST_STATE_READY,
+                             G_PARAM_READWRITE);
+
+    obj_properties[PROP_INCREMENTAL_RECONFIGURATION_TAG] =
+            g_param_spec_boolean("incremental_reconfiguration",
+                                 "Incremental Reconfiguration",
+                                 "Only rebuilds the segments which differ when parse_launch_pipeline changes",
+                                 FALSE,
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_ASYNC_TEARDOWN_TAG] =
+            g_param_spec_boolean("async_teardown",
+                                 "Asynchronous Teardown",
+                                 "Brings old pipelines down to NULL on a background reaper thread",
+                                 FALSE,
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_CB_ON_RCT_GST_PIPELINE_TEARDOWN_TAG] =
+            g_param_spec_pointer("on_rct_gst_pipeline_teardown",
+                                 "On GST Pipeline Teardown",
+                                 "Callback which will be called when an old pipeline has been destroyed, with the time it took",
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_USE_SHARED_EXECUTOR_TAG] =
+            g_param_spec_boolean("use_shared_executor",
+                                 "Use Shared Executor",
+                                 "Runs the player on the shared executor (if initialized) instead of a dedicated thread",
+                                 FALSE,
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_ELEMENT_MESSAGE_FORMAT_TAG] =
+            g_param_spec_int("element_message_format",
+                             "Element Message Format",
+                             "Encoding of element messages (RctGstMessageFormat)",
+                             RCT_GST_MESSAGE_FORMAT_JSON,
+                             RCT_GST_MESSAGE_FORMAT_BINARY,
+                             RCT_GST_MESSAGE_FORMAT_JSON,
+                             G_PARAM_READWRITE);
+
+    obj_properties[PROP_CB_ON_RCT_GST_ELEMENT_MESSAGE_BINARY_TAG] =
+            g_param_spec_pointer("on_rct_gst_element_message_binary",
+                                 "On GST Element Binary Message",
+                                 "Callback which will be called with binary encoded element messages",
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_PROPERTY_BATCH_INTERVAL_TAG] =
+            g_param_spec_uint("property_batch_interval",
+                              "Property Batch Interval",
+                              "Milliseconds between two applications of pending property writes (0 applies them right away)",
+                              0,
+                              1000,
+                              0,
+                              G_PARAM_READWRITE);
+
+    obj_properties[PROP_PROPERTY_BATCH_FRAME_ALIGNED_TAG] =
+            g_param_spec_boolean("property_batch_frame_aligned",
+                                 "Property Batch Frame Aligned",
+                                 "Apply pending property writes once per video frame when the frame rate is known",
+                                 FALSE,
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_TRACE_LEVEL_TAG] =
+            g_param_spec_int("trace_level",
+                             "Trace Level",
+                             "Verbosity of the trace records (RctGstTraceLevel), see rct_gst_player_dump_trace",
+                             RCT_GST_TRACE_LEVEL_NONE,
+                             RCT_GST_TRACE_LEVEL_DEBUG,
+                             RCT_GST_TRACE_LEVEL_ERROR,
+                             G_PARAM_READWRITE);
+
+    obj_properties[PROP_STATS_INTERVAL_TAG] =
+            g_param_spec_uint("stats_interval",
+                              "Stats Interval",
+                              "Milliseconds between two calls of on_rct_gst_player_stats (0 disables them)",
+                              0,
+                              G_MAXUINT,
+                              0,
+                              G_PARAM_READWRITE);
+
+    obj_properties[PROP_CB_ON_RCT_GST_PLAYER_STATS_TAG] =
+            g_param_spec_pointer("on_rct_gst_player_stats",
+                                 "On GST Player Stats",
+                                 "Callback which will be called periodically with a snapshot of the player statistics",
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_CB_ON_RCT_GST_STARTUP_TIMINGS_TAG] =
+            g_param_spec_pointer("on_rct_gst_startup_timings",
+                                 "On GST Startup Timings",
+                                 "Callback which will be called once a new pipeline has played its first buffers",
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_CB_ON_RCT_GST_SEEK_DONE_TAG] =
+            g_param_spec_pointer("on_rct_gst_seek_done",
+                                 "On GST Seek Done",
+                                 "Callback which will be called once a seek is done, with its latency",
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_POSITION_UPDATE_INTERVAL_TAG] =
+            g_param_spec_uint("position_update_interval",
+                              "Position Update Interval",
+                              "Milliseconds between two position queries while playing (0 disables them)",
+                              0,
+                              G_MAXUINT,
+                              0,
+                              G_PARAM_READWRITE);
+
+    obj_properties[PROP_POSITION_UPDATE_THRESHOLD_TAG] =
+            g_param_spec_uint("position_update_threshold",
+                              "Position Update Threshold",
+                              "Milliseconds the position has to move by before being reported again",
+                              0,
+                              G_MAXUINT,
+                              100,
+                              G_PARAM_READWRITE);
+
+    obj_properties[PROP_CB_ON_RCT_GST_PIPELINE_POSITION_TAG] =
+            g_param_spec_pointer("on_rct_gst_pipeline_position",
+                                 "On GST Pipeline Position",
+                                 "Callback which will be called with the position and duration of the pipeline",
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_LIVE_LOW_LATENCY_TAG] =
+            g_param_spec_boolean("live_low_latency",
+                                 "Live Low Latency",
+                                 "Tunes queues, jitterbuffers, decoders and sinks of the next pipelines for latency",
+                                 FALSE,
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_LIVE_LATENCY_TAG] =
+            g_param_spec_uint("live_latency",
+                              "Live Latency",
+                              "Milliseconds of jitter absorbed by jitterbuffers when live_low_latency is set",
+                              0,
+                              G_MAXUINT,
+                              50,
+                              G_PARAM_READWRITE);
+
+    obj_properties[PROP_BUFFERING_MODE_TAG] =
+            g_param_spec_int("buffering_mode",
+                             "Buffering Mode",
+                             "Buffering of the URIs of the next pipelines (RctGstBufferingMode)",
+                             RCT_GST_BUFFERING_AUTO,
+                             RCT_GST_BUFFERING_NONE,
+                             RCT_GST_BUFFERING_AUTO,
+                             G_PARAM_READWRITE);
+
+    obj_properties[PROP_BUFFERING_LOW_WATERMARK_TAG] =
+            g_param_spec_uint("buffering_low_watermark",
+                              "Buffering Low Watermark",
+                              "Percent under which playback is paused to buffer",
+                              0,
+                              100,
+                              10,
+                              G_PARAM_READWRITE);
+
+    obj_properties[PROP_BUFFERING_HIGH_WATERMARK_TAG] =
+            g_param_spec_uint("buffering_high_watermark",
+                              "Buffering High Watermark",
+                              "Percent from which playback resumes after buffering",
+                              0,
+                              100,
+                              100,
+                              G_PARAM_READWRITE);
+
+    obj_properties[PROP_CB_ON_RCT_GST_BUFFERING_TAG] =
+            g_param_spec_pointer("on_rct_gst_buffering",
+                                 "On GST Buffering",
+                                 "Callback which will be called with the buffering percent and the microseconds until ready",
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_PLAYLIST_LOOP_TAG] =
+            g_param_spec_boolean("playlist_loop",
+                                 "Playlist Loop",
+                                 "Starts the playlist over after its last item",
+                                 FALSE,
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_CB_ON_RCT_GST_PLAYLIST_ITEM_TAG] =
+            g_param_spec_pointer("on_rct_gst_playlist_item",
+                                 "On GST Playlist Item",
+                                 "Callback which will be called once an item plays, with the gap measured since the previous one",
+                                 G_PARAM_READWRITE);
+
+    obj_properties[PROP_MEMORY_BUDGET_TAG] =
+            g_param_spec_uint64("memory_budget",
+                                "Memory Budget",
+                                "Bytes shared between the queues of the next pipelines, 0 to keep their own limits",
+                                0,
+                                G_MAXUINT64,
+                                0,
+                                G_PARAM_READWRITE);
+
+    obj_properties[PROP_CB_ON_RCT_GST_MEMORY_BUDGET_TAG] =
+            g_param_spec_pointer("on_rct_gst_memory_budget",
+                                 "On GST Memory Budget",
+                                 "Callback which will be called with the buffered bytes once the queues get close to the memory budget",
+                                 G_PARAM_READWRITE);
+
     g_object_class_install_properties(object_class,
                                       N_PROPERTIES,
                                       obj_properties);
 }
 
 static void __unused rct_gst_player_init(RctGstPlayer *self) {
+    guint i = 0;
+
     self->parse_launch_pipeline = NULL;
     self->drawable_surface = NULL;
     self->desired_state = GST_STATE_VOID_PENDING;
     self->loop = NULL;
+    self->context = NULL;
+    self->bus = NULL;
+    self->bus_watch = NULL;
+    g_mutex_init(&self->bus_queue_lock);
+    for (i = 0; i < RCT_GST_N_BUS_PRIORITIES; i++)
+        g_queue_init(&self->bus_queues[i]);
+    self->use_shared_executor = FALSE;
+    self->executor_worker = NULL;
+    self->commands = NULL;
+    self->commands_scheduled = FALSE;
+    self->stopped = FALSE;
     self->user_data = NULL;
+
+    self->element_message_format = RCT_GST_MESSAGE_FORMAT_JSON;
+    self->message_buffer = g_byte_array_sized_new(256);
+    self->on_rct_gst_element_message_binary = NULL;
+
+    g_mutex_init(&self->element_messages_lock);
+    self->message_throttles = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                                    (GDestroyNotify) rct_gst_message_throttle_free);
+
+    self->message_subscriptions =
+            g_ptr_array_new_with_free_func((GDestroyNotify) rct_gst_message_subscription_free);
+    self->message_fields = g_array_new(FALSE, FALSE, sizeof(GQuark));
+    self->last_subscription_id = 0;
+
+    self->element_targets = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+                                                  (GDestroyNotify) rct_gst_element_target_free);
+    self->element_targets_stale = FALSE;
+    self->property_cache_hits = 0;
+    self->property_cache_misses = 0;
+
+    self->property_batch_interval = 0;
+    self->property_batch_frame_aligned = FALSE;
+    self->pending_writes = g_ptr_array_new();
+    self->property_batch_source = NULL;
+    self->property_writes_applied = 0;
+    self->property_writes_elided = 0;
+
+    self->trace_level = RCT_GST_TRACE_LEVEL_ERROR;
+    self->trace_records = NULL;
+    self->trace_head = 0;
+    self->trace_epoch = g_get_monotonic_time();
+
+    g_mutex_init(&self->stats_lock);
+    self->start_time = 0;
+    memset(self->bus_messages, 0, sizeof(self->bus_messages));
+    self->qos_stats = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    memset(self->callback_stats, 0, sizeof(self->callback_stats));
+    for (i = 0; i < G_N_ELEMENTS(self->state_change_durations); i++)
+        self->state_change_durations[i] = -1;
+    self->state_change_target = GST_STATE_VOID_PENDING;
+    self->state_change_start = 0;
+    self->stats_interval = 0;
+    self->stats_source = NULL;
+    self->on_rct_gst_player_stats = NULL;
+
+    self->startup_origin = 0;
+    self->startup_timings.parsed = -1;
+    self->startup_timings.ready = -1;
+    self->startup_timings.paused = -1;
+    self->startup_timings.playing = -1;
+    self->startup_timings.first_video_buffer = -1;
+    self->startup_timings.first_audio_buffer = -1;
+    self->startup_probes = g_ptr_array_new();
+    self->startup_pending = 0;
+    self->startup_generation = 0;
+    self->startup_reported = FALSE;
+    self->element_added_handler = 0;
+    self->on_rct_gst_startup_timings = NULL;
+
+    self->live_low_latency = FALSE;
+    self->live_latency = 50;
+    self->latency_probes = g_ptr_array_new();
+    self->latency_generation = 0;
+    self->latency_element_added_handler = 0;
+    self->measured_latency = GST_CLOCK_TIME_NONE;
+    self->max_measured_latency = GST_CLOCK_TIME_NONE;
+
+    self->memory_budget = 0;
+    self->pipeline_memory_budget = 0;
+    self->budget_queues = g_ptr_array_new_with_free_func(gst_object_unref);
+    self->budget_element_added_handler = 0;
+    self->budget_source = NULL;
+    self->max_buffered_bytes = 0;
+    self->over_budget = FALSE;
+    self->on_rct_gst_memory_budget = NULL;
+
+    self->buffering_mode = RCT_GST_BUFFERING_AUTO;
+    self->buffering_low_watermark = 10;
+    self->buffering_high_watermark = 100;
+    self->buffering_live = -1;
+    self->buffering = FALSE;
+    self->buffering_percent = -1;
+    self->buffering_start_percent = 0;
+    self->buffering_start = 0;
+    self->rebuffers = 0;
+    self->buffering_time = 0;
+    self->on_rct_gst_buffering = NULL;
+
+    self->playlist = g_ptr_array_new_with_free_func(g_free);
+    self->playlist_index = -1;
+    self->playlist_next = -1;
+    self->playlist_loop = FALSE;
+    self->preloaded_launch = NULL;
+    self->preloaded_pipeline = NULL;
+    self->preloaded_element_added_handler = 0;
+    self->preloaded_probe = NULL;
+    self->playlist_prerolled = FALSE;
+    self->playlist_probe = NULL;
+    self->playlist_probe_video = FALSE;
+    self->playlist_element_added_handler = 0;
+    self->about_to_finish_handler = 0;
+    self->playlist_last_buffer = -1;
+    self->playlist_boundary = FALSE;
+    self->playlist_gap = -1;
+    self->on_rct_gst_playlist_item = NULL;
+
+    self->position_update_interval = 0;
+    self->position_update_threshold = 100;
+    self->position_source = NULL;
+    self->last_position = -1;
+    self->last_duration = -1;
+    self->on_rct_gst_pipeline_position = NULL;
+
+    self->seek_in_flight = FALSE;
+    self->seek_start = 0;
+    self->seek_pending = FALSE;
+    self->pending_seek_position = 0;
+    self->pending_seek_mode = RCT_GST_SEEK_ACCURATE;
+    self->pending_seek_start = 0;
+    self->seeks_superseded = 0;
+    self->on_rct_gst_seek_done = NULL;
+
+    self->frame_taps = g_ptr_array_new_with_free_func((GDestroyNotify) rct_gst_frame_tap_unref);
+    self->last_frame_tap_id = 0;
+
+    self->snapshot_sources = g_ptr_array_new_with_free_func((GDestroyNotify) g_source_unref);
+
+    self->pipeline_cache = g_queue_new();
+    self->pipeline_cache_size = 0;
+    self->pipeline_cache_state = GST_STATE_READY;
+    self->pipeline_cache_hits = 0;
+    self->pipeline_cache_misses = 0;
+
+    self->incremental_reconfiguration = FALSE;
+
+    self->async_teardown = FALSE;
+    self->last_teardown_duration = 0;
+    self->on_rct_gst_pipeline_teardown = NULL;
 }
@@ -12,6 +12,188 @@ G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (RctGstPlayer, rct_gst_player, RCT_GST, PLAYER, GObject)
 
+typedef enum {
+    RCT_GST_EXECUTOR_ROUND_ROBIN,
+    RCT_GST_EXECUTOR_LEAST_LOADED
+} RctGstExecutorPolicy;
+
+// Streaming threads, by the element they stream for
+typedef enum {
+    RCT_GST_TASK_ROLE_OTHER,
+    RCT_GST_TASK_ROLE_AUDIO_SINK,
+    RCT_GST_TASK_ROLE_VIDEO_SINK,
+    RCT_GST_TASK_ROLE_DEMUX_DECODE,
+    RCT_GST_N_TASK_ROLES
+} RctGstTaskRole;
+
+// Durations in microseconds
+typedef struct {
+    guint threads;      // Running a task
+    gint max_threads;   // -1 when unbounded
+    guint peak_threads;
+    guint queued_tasks; // Pushed, waiting for their thread to start
+    guint64 tasks;      // Started since the pool was installed
+    guint64 overflow_tasks; // Pushed with every thread taken, the pool growing past max_threads
+    gint64 mean_scheduling_latency;
+    gint64 max_scheduling_latency;
+} RctGstTaskPoolStats;
+
+typedef enum {
+    RCT_GST_MESSAGE_FORMAT_JSON,
+    RCT_GST_MESSAGE_FORMAT_BINARY
+} RctGstMessageFormat;
+
+// Binary element messages are a sequence of fields, in host byte order :
+//   [guint8 type][guint16 name length][name bytes][value]
+// Array entries are encoded the same way, without name. Values are :
+//   INT32, UINT32, FLOAT : 4 bytes - INT64, UINT64, DOUBLE : 8 bytes - BOOLEAN : 1 byte
+//   STRING : [guint32 length][bytes] - ARRAY : [guint32 count][entries] - NULL : nothing
+typedef enum {
+    RCT_GST_BINARY_NULL = 0,
+    RCT_GST_BINARY_INT32,
+    RCT_GST_BINARY_UINT32,
+    RCT_GST_BINARY_INT64,
+    RCT_GST_BINARY_UINT64,
+    RCT_GST_BINARY_FLOAT,
+    RCT_GST_BINARY_DOUBLE,
+    RCT_GST_BINARY_BOOLEAN,
+    RCT_GST_BINARY_STRING,
+    RCT_GST_BINARY_ARRAY,
+    RCT_GST_BINARY_UNSUPPORTED = 0xFF
+} RctGstBinaryType;
+
+// Verbosity of the trace records
+typedef enum {
+    RCT_GST_TRACE_LEVEL_NONE,
+    RCT_GST_TRACE_LEVEL_ERROR,
+    RCT_GST_TRACE_LEVEL_INFO,  // Setters and pipeline lifecycle
+    RCT_GST_TRACE_LEVEL_DEBUG  // State changes of every element
+} RctGstTraceLevel;
+
+// User callbacks timed by the player statistics
+typedef enum {
+    RCT_GST_CALLBACK_PLAYER_LOADED,
+    RCT_GST_CALLBACK_STATE_CHANGED,
+    RCT_GST_CALLBACK_EOS,
+    RCT_GST_CALLBACK_ERROR,
+    RCT_GST_CALLBACK_ELEMENT_MESSAGE, // JSON and binary
+    RCT_GST_CALLBACK_PIPELINE_TEARDOWN,
+    RCT_GST_CALLBACK_STARTUP_TIMINGS,
+    RCT_GST_CALLBACK_FRAME_TAP,
+    RCT_GST_CALLBACK_SNAPSHOT, // Snapshots and thumbnails
+    RCT_GST_CALLBACK_SEEK_DONE,
+    RCT_GST_CALLBACK_POSITION,
+    RCT_GST_CALLBACK_BUFFERING,
+    RCT_GST_CALLBACK_PLAYLIST_ITEM,
+    RCT_GST_CALLBACK_MEMORY_BUDGET,
+    RCT_GST_N_CALLBACKS
+} RctGstCallbackType;
+
+// Durations in microseconds
+typedef struct {
+    guint64 calls;
+    gint64 total_time;
+    gint64 max_time;
+} RctGstCallbackStats;
+
+typedef struct {
+    gchar *element_name;
+    guint buffers;
+    guint bytes;
+    guint64 time;
+    guint max_buffers;
+    guint max_bytes;
+    guint64 max_time;
+} RctGstQueueStats;
+
+// Microseconds from parse_launch_pipeline being applied to each startup step, -1 when the step
+// hasn't been passed through (cached pipelines are already prerolled). Pipelines reconfigured in
+// place are playing as soon as parsed, only their first buffers being measured again.
+typedef struct {
+    gint64 parsed;
+    gint64 ready;
+    gint64 paused; // Prerolled
+    gint64 playing;
+    gint64 first_video_buffer;
+    gint64 first_audio_buffer;
+} RctGstStartupTimings;
+
+typedef struct {
+    gint64 uptime; // Microseconds since the player started
+
+    // Frames, from the sinks counters when they have some, from QoS messages otherwise
+    guint64 rendered_frames;
+    guint64 dropped_frames;
+    gboolean sink_counters;
+
+    // Latency query of the current pipeline
+    gboolean live;
+    GstClockTime min_latency;
+    GstClockTime max_latency;
+
+    // From the running time of buffers to their rendering, with "live_low_latency" set
+    GstClockTime measured_latency; // Of the last buffer, GST_CLOCK_TIME_NONE when unknown
+    GstClockTime max_measured_latency;
+
+    // Pauses to buffer once the pipeline has been playing, and microseconds spent buffering
+    guint64 rebuffers;
+    gint64 buffering_time;
+
+    GArray *queues; // RctGstQueueStats of every queue, queue2 and multiqueue (all its queues summed)
+
+    // Bytes held by those queues, their peak over the budget checks, and the budget they share
+    // (see "memory_budget"), 0 for none
+    guint64 buffered_bytes;
+    guint64 max_buffered_bytes;
+    guint64 memory_budget;
+
+    // Indexed by the bit of the GstMessageType, extended types all counted in the last one
+    guint64 bus_messages[32];
+
+    RctGstCallbackStats callbacks[RCT_GST_N_CALLBACKS];
+
+    // Microseconds taken by the pipeline to reach each state last time it was desired, -1 if never
+    gint64 state_change_durations[GST_STATE_PLAYING + 1];
+
+    RctGstStartupTimings startup; // Of the current pipeline
+} RctGstPlayerStats;
+
+// Called once a posted command has been applied on the player thread.
+// applied is FALSE when the command has been superseded by a later one of the same kind, or posted
+// after the player stopped (then called from the stopping thread, or on finalize).
+typedef void (*RctGstPlayerCommandCallback)(RctGstPlayer *self, gboolean applied, gpointer user_data);
+
+// Typed property write. Values are converted to the type of the property when needed :
+// integers to enums and flags, strings deserialized (caps, enum nicks...), numbers transformed.
+typedef struct {
+    const gchar *element_name;
+    const gchar *property_name;
+    GValue value;
+} RctGstPropertyEntry;
+
+typedef struct _RctGstPropertyBatch RctGstPropertyBatch;
+
+// Buffering of network URIs (see "buffering_mode" property)
+typedef enum {
+    RCT_GST_BUFFERING_AUTO,     // Download for progressive HTTP, stream for adaptive manifests
+    RCT_GST_BUFFERING_STREAM,   // In memory, ahead of the playback position
+    RCT_GST_BUFFERING_DOWNLOAD, // Whole file to disk, formats permitting
+    RCT_GST_BUFFERING_NONE      // Buffering messages are ignored
+} RctGstBufferingMode;
+
+typedef enum {
+    RCT_GST_SEEK_KEY_UNIT, // Key unit before the position, fastest
+    RCT_GST_SEEK_SNAP,     // Nearest key unit
+    RCT_GST_SEEK_ACCURATE  // Exactly at the position, decoding from the key unit before it
+} RctGstSeekMode;
+
+// Called on a streaming thread with a frame mapped in place, in the negotiated raw format.
+// The frame stays valid until given back to rct_gst_frame_tap_release, from any thread.
+typedef void (*RctGstFrameTapCallback)(RctGstPlayer *self,
+                                       guint tap_id,
+                                       GstVideoFrame *frame,
+                                       gpointer user_data);
+
 __unused
 
 // Methods definitions
@@ -26,8 +208,217 @@ RctGstPlayer *rct_gst_player_new(const gchar *debug_tag,
 void rct_gst_player_start(RctGstPlayer *self); // Prepares and runs the player in a thread
 void rct_gst_player_set_pipeline_properties(RctGstPlayer *self, const gchar *pipeline_properties);
 
+// Elements and properties are resolved once per pipeline, then looked up from a cache
+void rct_gst_player_get_property_cache_stats(RctGstPlayer *self,
+                                             guint64 *hits,
+                                             guint64 *misses);
+
+// Property writes (see "property_batch_interval" and "property_batch_frame_aligned" properties) :
+// writes which don't change the value are elided, the others are applied once per tick
+void rct_gst_player_get_property_write_stats(RctGstPlayer *self,
+                                             guint64 *applied,
+                                             guint64 *elided);
+
+// Typed property writes, without any JSON. Entries and values are copied.
+void rct_gst_player_set_properties(RctGstPlayer *self,
+                                   const RctGstPropertyEntry *entries,
+                                   guint n_entries);
+void rct_gst_player_set_property_value(RctGstPlayer *self,
+                                       const gchar *element_name,
+                                       const gchar *property_name,
+                                       const GValue *value);
+
+RctGstPropertyBatch *rct_gst_property_batch_new(void);
+void rct_gst_property_batch_free(RctGstPropertyBatch *batch);
+void rct_gst_property_batch_add_value(RctGstPropertyBatch *batch,
+                                      const gchar *element_name,
+                                      const gchar *property_name,
+                                      const GValue *value);
+void rct_gst_property_batch_add_int(RctGstPropertyBatch *batch,
+                                    const gchar *element_name,
+                                    const gchar *property_name,
+                                    gint64 value);
+void rct_gst_property_batch_add_double(RctGstPropertyBatch *batch,
+                                       const gchar *element_name,
+                                       const gchar *property_name,
+                                       gdouble value);
+void rct_gst_property_batch_add_boolean(RctGstPropertyBatch *batch,
+                                        const gchar *element_name,
+                                        const gchar *property_name,
+                                        gboolean value);
+void rct_gst_property_batch_add_string(RctGstPropertyBatch *batch,
+                                       const gchar *element_name,
+                                       const gchar *property_name,
+                                       const gchar *value);
+
+// Non-blocking mutations, applied in order on the player thread
+void rct_gst_player_post_desired_state(RctGstPlayer *self,
+                                       GstState state,
+                                       RctGstPlayerCommandCallback callback,
+                                       gpointer user_data);
+void rct_gst_player_post_parse_launch_pipeline(RctGstPlayer *self,
+                                               const gchar *parse_launch_pipeline,
+                                               RctGstPlayerCommandCallback callback,
+                                               gpointer user_data);
+void rct_gst_player_post_drawable_surface(RctGstPlayer *self,
+                                          gpointer drawable_surface,
+                                          RctGstPlayerCommandCallback callback,
+                                          gpointer user_data);
+void rct_gst_player_post_pipeline_properties(RctGstPlayer *self,
+                                             const gchar *pipeline_properties,
+                                             RctGstPlayerCommandCallback callback,
+                                             gpointer user_data);
+void rct_gst_player_post_property_batch(RctGstPlayer *self,
+                                        RctGstPropertyBatch *batch, // Ownership is taken
+                                        RctGstPlayerCommandCallback callback,
+                                        gpointer user_data);
+
+// Flushing seek (see "on_rct_gst_seek_done" callback). While one is in progress, only the latest
+// seek requested is kept for afterwards : scrubbing doesn't pile seeks up.
+void rct_gst_player_post_seek(RctGstPlayer *self,
+                              GstClockTime position,
+                              RctGstSeekMode mode,
+                              RctGstPlayerCommandCallback callback,
+                              gpointer user_data);
+// Superseded seeks count both requests replaced while waiting and commands coalesced before applying.
+void rct_gst_player_get_seek_stats(RctGstPlayer *self, guint64 *superseded);
+
+// Playlist of URIs or launch strings (see "playlist_loop" and "on_rct_gst_playlist_item" properties).
+// The next item is prerolled while the current one plays, and EOS is only reported at the end.
+// Consecutive URIs share one playbin, switching without gap. "async_teardown" keeps the release of
+// the previous pipeline out of the other switches.
+void rct_gst_player_post_playlist_enqueue(RctGstPlayer *self,
+                                          const gchar *item,
+                                          RctGstPlayerCommandCallback callback,
+                                          gpointer user_data);
+void rct_gst_player_post_playlist_skip(RctGstPlayer *self,
+                                       RctGstPlayerCommandCallback callback,
+                                       gpointer user_data);
+void rct_gst_player_post_playlist_clear(RctGstPlayer *self, // The current item keeps playing
+                                        RctGstPlayerCommandCallback callback,
+                                        gpointer user_data);
+
+// Latency query of the current pipeline, from any thread. FALSE when it couldn't be answered.
+gboolean rct_gst_player_query_latency(RctGstPlayer *self,
+                                      gboolean *live,
+                                      GstClockTime *min_latency,
+                                      GstClockTime *max_latency);
+
 void rct_gst_player_stop(RctGstPlayer *self);
 
+// Element messages subscriptions : once there is at least one, only the messages matching a
+// subscription are delivered. NULL names match anything, NULL fields means all fields.
+guint rct_gst_player_subscribe_element_messages(RctGstPlayer *self,
+                                                const gchar *element_name,
+                                                const gchar *structure_name,
+                                                const gchar *const *fields);
+void rct_gst_player_unsubscribe_element_messages(RctGstPlayer *self, guint subscription_id);
+
+// Element messages rate limit, by element name or structure name (0 removes the limit).
+// Within each second, messages over the limit are coalesced : only the latest one is delivered.
+void rct_gst_player_set_element_message_rate_limit(RctGstPlayer *self,
+                                                   const gchar *name,
+                                                   guint max_per_second);
+gboolean rct_gst_player_get_element_message_throttle_stats(RctGstPlayer *self,
+                                                           const gchar *name,
+                                                           guint64 *delivered,
+                                                           guint64 *coalesced);
+
+// Frame taps : the src pad of the named element is teed off through a leaky queue into an appsink,
+// in the current pipeline and the following ones. Frames are dropped rather than waited for :
+// over max_rate per second (0 for no limit), or while max_in_flight frames aren't released yet.
+guint rct_gst_player_add_frame_tap(RctGstPlayer *self,
+                                   const gchar *element_name,
+                                   gdouble max_rate,
+                                   guint max_in_flight,
+                                   RctGstFrameTapCallback callback,
+                                   gpointer user_data);
+void rct_gst_player_remove_frame_tap(RctGstPlayer *self, guint tap_id); // No callback afterwards
+gboolean rct_gst_player_get_frame_tap_stats(RctGstPlayer *self,
+                                            guint tap_id,
+                                            guint64 *delivered,
+                                            guint64 *dropped);
+void rct_gst_frame_tap_release(GstVideoFrame *frame);
+
+// Snapshots : scaled and encoded on a worker thread, delivered on the player thread.
+// A width or height <= 0 follows the aspect ratio, both for the original size.
+typedef enum {
+    RCT_GST_SNAPSHOT_PNG,
+    RCT_GST_SNAPSHOT_JPEG
+} RctGstSnapshotFormat;
+
+typedef struct {
+    GstClockTime position; // Of the key frame
+    const guint8 *data;
+    gsize size;
+} RctGstThumbnail;
+
+// data is NULL when there was nothing to snapshot. Images are only valid during the callback.
+// Callbacks are always called once, on the player thread while it runs, otherwise on a snapshot
+// worker or the thread stopping the player.
+typedef void (*RctGstSnapshotCallback)(RctGstPlayer *self,
+                                       const guint8 *data,
+                                       gsize size,
+                                       gpointer user_data);
+typedef void (*RctGstThumbnailsCallback)(RctGstPlayer *self,
+                                         const RctGstThumbnail *thumbnails,
+                                         guint n_thumbnails,
+                                         gpointer user_data);
+
+// Last frame rendered by the video sink
+void rct_gst_player_snapshot(RctGstPlayer *self,
+                             gint width,
+                             gint height,
+                             RctGstSnapshotFormat format,
+                             RctGstSnapshotCallback callback,
+                             gpointer user_data);
+// Frame of a frame tap, which can be released as soon as this returns
+void rct_gst_player_snapshot_frame(RctGstPlayer *self,
+                                   const GstVideoFrame *frame,
+                                   gint width,
+                                   gint height,
+                                   RctGstSnapshotFormat format,
+                                   RctGstSnapshotCallback callback,
+                                   gpointer user_data);
+// Strip of key frames evenly spread over an URI, only key frames being decoded
+void rct_gst_player_extract_thumbnails(RctGstPlayer *self,
+                                       const gchar *uri,
+                                       guint n_thumbnails,
+                                       gint width,
+                                       gint height,
+                                       RctGstSnapshotFormat format,
+                                       RctGstThumbnailsCallback callback,
+                                       gpointer user_data);
+
+// Shared executor : players with "use_shared_executor" set run on one of these threads
+gboolean rct_gst_player_executor_init(guint n_workers, RctGstExecutorPolicy policy);
+
+// Shared task pool : streaming tasks of the pipelines built afterwards run on these threads.
+// A task keeps its thread until its element stops, so max_threads (-1 for no bound) should cover the
+// tasks of all the concurrent pipelines. A task never waits for another one to stop : past the bound
+// the pool grows, and counts it as an overflow. Only pipelines built after it was installed use it.
+gboolean rct_gst_player_task_pool_init(gint max_threads);
+// Niceness and CPUs (bit n for CPU n, 0 for any) of the task threads of a role, once the pool is
+// installed. Linux and Android only.
+void rct_gst_player_set_task_scheduling(RctGstTaskRole role, gint nice, guint64 cpu_mask);
+void rct_gst_player_get_task_pool_stats(RctGstTaskPoolStats *stats);
+
+// Pipeline cache (see "pipeline_cache_size" and "pipeline_cache_state" properties)
+void rct_gst_player_clear_pipeline_cache(RctGstPlayer *self);
+void rct_gst_player_get_pipeline_cache_stats(RctGstPlayer *self,
+                                             guint64 *hits,
+                                             guint64 *misses,
+                                             guint *cached_pipelines);
+
+// Statistics snapshot, callable from any thread (see also "stats_interval" property and
+// "on_rct_gst_player_stats" callback)
+RctGstPlayerStats *rct_gst_player_get_stats(RctGstPlayer *self);
+void rct_gst_player_stats_free(RctGstPlayerStats *stats);
+
+// Trace records (see "trace_level" property) : the latest ones, oldest first, formatted on demand.
+// Returns a newly allocated string.
+gchar *rct_gst_player_dump_trace(RctGstPlayer *self);
+
 gpointer rct_gst_player_get_user_data(RctGstPlayer *self);
 
 G_END_DECLS